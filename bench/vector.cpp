@@ -0,0 +1,986 @@
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include "bench.h"
+#include "deque.h"
+#include "indexedvector.h"
+#include "mappedvector.h"
+#include "segmentedvector.h"
+#include "sharedvector.h"
+#include "smallvector.h"
+#include "sortedvector.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+typedef int (*compareFunction)(const int &left, const int &right);
+
+/*
+ * returns the same random numbers for every call with the same size
+ */
+const int *randomNumbers(int size) {
+  static Vector<int> numbers(1);
+  if (numbers.size() < size) {
+    srand(42);
+    numbers.clear();
+    for (int i = 0; i < size; ++i) numbers << rand();
+  }
+  return numbers.view().begin();
+}
+
+void fillSorted(int *array, int size) {
+  for (int i = 0; i < size; ++i) array[i] = i;
+}
+
+void fillReversed(int *array, int size) {
+  for (int i = 0; i < size; ++i) array[i] = size - i;
+}
+
+void fillOrganPipe(int *array, int size) {
+  for (int i = 0; i < size; ++i) array[i] = i < size / 2 ? i : size - i;
+}
+
+void fillFewUnique(int *array, int size) {
+  const int *random = randomNumbers(size);
+  for (int i = 0; i < size; ++i) array[i] = random[i] % 8;
+}
+
+void fillRandom(int *array, int size) {
+  memcpy(array, randomNumbers(size), sizeof(int) * size);
+}
+
+int plainCompare(const int &left, const int &right) {
+  return defaultCompare(left, right);
+}
+
+/*
+ * the quicksort that was used by Vector::sort before introsort, it is kept
+ * here as the baseline for the comparison. Like Vector::sort it compares
+ * through a function pointer.
+ */
+void legacyQuicksort(int *elements, int left, int right, compareFunction fn) {
+  if (left >= right) return;
+  int i = left;
+  int j = right - 1;
+  int pivot = elements[right];
+  
+  do {
+    while (fn(elements[i], pivot) <= 0 && i < right) i++;
+    while (fn(elements[j], pivot) >= 0 && j > left) j--;
+    if (i < j) Foundation::swap(elements[i], elements[j]);
+  } while (i < j);
+  
+  if (fn(elements[i], pivot) > 0) {
+    Foundation::swap(elements[i], elements[right]);
+  }
+  
+  legacyQuicksort(elements, left, i - 1, fn);
+  legacyQuicksort(elements, i + 1, right, fn);
+}
+
+/*
+ * appends size items to a new vector
+ */
+void benchAppend(Bench::Timer &timer) {
+  Vector<int> vector;
+  for (int i = 0; i < timer.size(); ++i) vector << i;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchAppendReserved(Bench::Timer &timer) {
+  Vector<int> vector;
+  vector.reserve(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << i;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchAppendSegmented(Bench::Timer &timer) {
+  SegmentedVector<int> vector;
+  for (int i = 0; i < timer.size(); ++i) vector << i;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * times the single append that crosses the capacity of a full vector,
+ * which has to grow
+ */
+void benchGrowVector(Bench::Timer &timer) {
+  Vector<int> vector(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << i;
+  timer.start();
+  vector << 0;
+  timer.stop();
+  timer.setItems(1);
+}
+
+void benchGrowSegmented(Bench::Timer &timer) {
+  SegmentedVector<int> vector;
+  vector.reserve(timer.size());
+  for (int i = 0; i < vector.capacity(); ++i) vector << i;
+  timer.start();
+  vector << 0;
+  timer.stop();
+  timer.setItems(1);
+}
+
+/*
+ * concatenates batches of 1000 items, one by one or in bulk
+ */
+void benchAppendBatches(Bench::Timer &timer) {
+  const int *batch = randomNumbers(1000);
+  Vector<int> vector;
+  for (int i = 0; i < timer.size() / 1000; ++i) {
+    for (int j = 0; j < 1000; ++j) vector << batch[j];
+  }
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchAppendBulk(Bench::Timer &timer) {
+  const int *batch = randomNumbers(1000);
+  Vector<int> vector;
+  for (int i = 0; i < timer.size() / 1000; ++i) vector.append(batch, 1000);
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * appends strings that are too long for the small string optimization by
+ * copying them in or by constructing them in place
+ */
+void benchAppendStringCopies(Bench::Timer &timer) {
+  Vector<string> vector;
+  string item(64, 'x');
+  for (int i = 0; i < timer.size(); ++i) vector << item;
+  timer.setItems(timer.size());
+}
+
+void benchAppendStringEmplace(Bench::Timer &timer) {
+  Vector<string> vector;
+  for (int i = 0; i < timer.size(); ++i) vector.emplace(64, 'x');
+  timer.setItems(timer.size());
+}
+
+/*
+ * searches an item that is not in the vector, using the passed kernels
+ */
+template <Simd::Level level>
+void benchIndex(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    for (int i = 0; i < timer.size(); ++i) vector << i % 100;
+  }
+  
+  Simd::setLevel(level);
+  timer.start();
+  int found = vector.index(101);
+  timer.stop();
+  Simd::setLevel(Simd::AVX2);
+  
+  if (found != -1) cout << "index found a missing item" << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchCount(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    for (int i = 0; i < timer.size(); ++i) vector << i % 100;
+  }
+  
+  timer.start();
+  int found = vector.count(1);
+  timer.stop();
+  
+  if (found != timer.size() / 100) cout << "count is wrong" << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * sums the vector through at(), like the aggregates had to be computed
+ * before there were kernels for them
+ */
+void benchSumLoop(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  
+  timer.start();
+  long sum = 0;
+  for (int i = 0; i < vector.size(); ++i) sum += vector.at(i);
+  timer.stop();
+  
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * sums the vector through [] of a vector with the passed bounds policy
+ */
+template <typename Bounds>
+void benchSumIndex(Bench::Timer &timer) {
+  static Vector<int, int, MallocAllocator, Bounds> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  
+  timer.start();
+  long sum = 0;
+  for (int i = 0; i < vector.size(); ++i) sum += vector[i];
+  timer.stop();
+  
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchSumRangeFor(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  
+  timer.start();
+  long sum = 0;
+  for (int item : vector) sum += item;
+  timer.stop();
+  
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+template <typename Item, Simd::Level level>
+void benchAggregates(Bench::Timer &timer) {
+  static Vector<Item> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    const int *random = randomNumbers(timer.size());
+    for (int i = 0; i < timer.size(); ++i) vector << (Item)(random[i] % 100000);
+  }
+  
+  Simd::setLevel(level);
+  timer.start();
+  double sum = (double)vector.sum();
+  std::pair<Item, Item> extremes = vector.minmax();
+  timer.stop();
+  Simd::setLevel(Simd::AVX2);
+  
+  if (sum == 42 || extremes.first == 42) cout << endl;
+  // the items are read twice
+  timer.setItems(timer.size() * 2);
+  timer.setBytes(timer.size() * 2 * sizeof(Item));
+}
+
+/*
+ * sorts the filled vector with sort(), which uses the radix sort for the
+ * defaultCompare and introsort for everything else
+ */
+template <void (*fill)(int *, int)>
+void benchSort(Bench::Timer &timer) {
+  Vector<int> vector(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << 0;
+  fill(&vector[0], timer.size());
+  
+  timer.start();
+  vector.sort(plainCompare);
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+template <void (*fill)(int *, int)>
+void benchLegacySort(Bench::Timer &timer) {
+  Vector<int> vector(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << 0;
+  fill(&vector[0], timer.size());
+  
+  timer.start();
+  legacyQuicksort(&vector[0], 0, timer.size() - 1, plainCompare);
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+void benchRadixSort(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.sort();
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+void benchSortLambda(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.sort([](const int &left, const int &right) { return left < right; });
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+template <unsigned threads>
+void benchSortParallel(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.sortParallel(threads, plainCompare);
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+/*
+ * cuts the vector into overlapping windows of size items
+ */
+void benchSlice(Bench::Timer &timer) {
+  static Vector<int> vector((int *)randomNumbers(1000000), 1000000);
+  long sum = 0;
+  timer.start();
+  for (int i = 0; i + timer.size() <= vector.size(); i += 100000) {
+    Vector<int> slice = vector.slice(i, timer.size());
+    sum += slice.first();
+  }
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(1000000 / 100000);
+}
+
+void benchView(Bench::Timer &timer) {
+  static Vector<int> vector((int *)randomNumbers(1000000), 1000000);
+  long sum = 0;
+  timer.start();
+  for (int i = 0; i + timer.size() <= vector.size(); i += 100000) {
+    VectorView<int> view = vector.view(i, timer.size());
+    sum += view.first();
+  }
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(1000000 / 100000);
+}
+
+/*
+ * passes the vector by value through a few layers, which only read it
+ */
+template <typename V>
+long passByValue(V vector, int layers) {
+  if (layers == 0) return vector.size();
+  return passByValue(vector, layers - 1) + 1;
+}
+
+void benchCopyVector(Bench::Timer &timer) {
+  static Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  long sum = 0;
+  timer.start();
+  sum += passByValue(vector, 4);
+  sum += vector.slice(timer.size() / 2).size();
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(6);
+}
+
+void benchCopySharedVector(Bench::Timer &timer) {
+  static SharedVector<int> vector(VectorView<int>(randomNumbers(timer.size()), timer.size()));
+  long sum = 0;
+  timer.start();
+  sum += passByValue(vector, 4);
+  sum += vector.slice(timer.size() / 2).size();
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(6);
+}
+
+/*
+ * removes every second item
+ */
+void benchRemove(Bench::Timer &timer) {
+  Vector<int> vector(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << i % 2;
+  timer.start();
+  vector.remove(1);
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+void benchLegacyRemove(Bench::Timer &timer) {
+  Vector<int> vector(timer.size());
+  for (int i = 0; i < timer.size(); ++i) vector << i % 2;
+  timer.start();
+  for (int i = 0; i < vector.size(); ++i) {
+    if (vector[i] == 1) vector.removeAt(i);
+  }
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+int square(int value) {
+  return value * value;
+}
+
+void benchMap(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.map(square);
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchMapLambda(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.map([](int value) { return value * value; });
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * an expensive mapping, to show the gain of the parallel map
+ */
+int mix(int value) {
+  unsigned hash = (unsigned)value;
+  for (int i = 0; i < 32; ++i) hash = (hash ^ (hash >> 15)) * 2654435761u;
+  return (int)hash;
+}
+
+void benchMapExpensive(Bench::Timer &timer) {
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.map([](int value) { return mix(value); });
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+/*
+ * maps using a pool with the passed number of threads, 0 uses the shared
+ * pool of the library
+ */
+template <unsigned threads>
+void benchParallelMap(Bench::Timer &timer) {
+  static ThreadPool pool(threads > 0 ? threads - 1 : 0);
+  ThreadPool &used = threads > 0 ? pool : ThreadPool::shared();
+  Vector<int> vector((int *)randomNumbers(timer.size()), timer.size());
+  timer.start();
+  vector.parallelMap(used, [](int value) { return mix(value); });
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+template <unsigned threads>
+void benchParallelReduce(Bench::Timer &timer) {
+  static ThreadPool pool(threads > 0 ? threads - 1 : 0);
+  ThreadPool &used = threads > 0 ? pool : ThreadPool::shared();
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  timer.start();
+  long sum = vector.parallelReduce(used, 0L, [](long sum, long value) { return sum + value; });
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * sums the squares of the even items, once by materializing every step and
+ * once fused using a pipe
+ */
+void benchFilterMapSumCopies(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  
+  timer.start();
+  Vector<int> even = vector.copy();
+  even.removeIf([](int value) { return value % 2 != 0; });
+  even.map([](int value) { return (value & 0xffff) * (value & 0xffff); });
+  long sum = 0;
+  for (int i = 0; i < even.size(); ++i) sum += even[i];
+  timer.stop();
+  
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchFilterMapSumPipe(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  
+  timer.start();
+  long sum = vector.pipe()
+    .filter([](int value) { return value % 2 == 0; })
+    .map([](int value) { return (value & 0xffff) * (value & 0xffff); })
+    .reduce(0L, [](long sum, int value) { return sum + value; });
+  timer.stop();
+  
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * creates, fills and destroys size short lived vectors like a request
+ */
+template <typename Allocator>
+long churn(int vectors, Allocator allocator) {
+  long sum = 0;
+  for (int round = 0; round < vectors; ++round) {
+    Vector<int, int, Allocator> vector(4, allocator);
+    for (int i = 0; i < 8 + round % 64; ++i) vector << i;
+    sum += vector.last();
+  }
+  return sum;
+}
+
+void benchMallocChurn(Bench::Timer &timer) {
+  churn(timer.size(), MallocAllocator());
+  timer.setItems(timer.size());
+}
+
+void benchArenaChurn(Bench::Timer &timer) {
+  static Arena arena;
+  churn(timer.size(), ArenaAllocator(arena));
+  arena.reset();
+  timer.setItems(timer.size());
+}
+
+void benchPoolChurn(Bench::Timer &timer) {
+  static Pool pool;
+  churn(timer.size(), PoolAllocator(pool));
+  timer.setItems(timer.size());
+}
+
+/*
+ * returns the path of a mapped vector with size random numbers, which is
+ * created by the first call
+ */
+string mappedNumbers(int size) {
+  string path = "/tmp/bench-mappedvector-" + to_string(size);
+  MappedVector<int> vector(path.c_str());
+  if (vector.size() != size) {
+    vector.clear();
+    vector.append(randomNumbers(size), size);
+  }
+  return path;
+}
+
+/*
+ * opens the same file as mapped vector and by reading it into a vector
+ */
+void benchMappedOpen(Bench::Timer &timer) {
+  static string path = mappedNumbers(timer.size());
+  timer.start();
+  MappedVector<int> vector(path.c_str());
+  vector.advise(MappedFile::SEQUENTIAL);
+  long sum = vector.sum();
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchReadOpen(Bench::Timer &timer) {
+  static string path = mappedNumbers(timer.size());
+  timer.start();
+  int fd = open(path.c_str(), O_RDONLY);
+  Vector<int> vector(timer.size());
+  lseek(fd, MappedFile::HEADER, SEEK_SET);
+  int buffer[4096];
+  while (vector.size() < timer.size()) {
+    size_t wanted = min(sizeof(buffer), (timer.size() - vector.size()) * sizeof(int));
+    ssize_t bytes = read(fd, buffer, wanted);
+    if (bytes <= 0) break;
+    vector.append(buffer, (int)(bytes / sizeof(int)));
+  }
+  close(fd);
+  long sum = vector.sum();
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * writes and reads back the items, once in the binary format and once as
+ * text like it was done before
+ */
+void benchWriteReadBinary(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  static int fd = dup(fileno(tmpfile()));
+  
+  timer.start();
+  lseek(fd, 0, SEEK_SET);
+  vector.writeTo(fd);
+  lseek(fd, 0, SEEK_SET);
+  Vector<int> read(timer.size());
+  read.readFrom(fd);
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+void benchWriteReadText(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  static int fd = dup(fileno(tmpfile()));
+  
+  timer.start();
+  string text = vector.toString();
+  pwrite(fd, text.data(), text.size(), 0);
+  string buffer(text.size(), ' ');
+  pread(fd, &buffer[0], buffer.size(), 0);
+  Vector<int> read(timer.size());
+  const char *position = buffer.c_str() + 1;
+  char *end;
+  for (int i = 0; i < timer.size(); ++i) {
+    read << (int)strtol(position, &end, 10);
+    position = end + 2;
+  }
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(timer.size() * sizeof(int));
+}
+
+/*
+ * formats the items like toString did before, using a stream
+ */
+template <typename Item>
+string legacyToString(const Vector<Item> &vector) {
+  ostringstream values;
+  values << "{";
+  for (int i = 0; i < vector.size(); ++i) {
+    values << vector.view().at(i);
+    if (i != vector.size() - 1) {
+      values << ", ";
+    }
+  }
+  values << "}";
+  return values.str();
+}
+
+template <typename Item>
+const Vector<Item> &formatNumbers(int size) {
+  static Vector<Item> vector(1);
+  if (vector.size() != size) {
+    vector.clear();
+    const int *numbers = randomNumbers(size);
+    for (int i = 0; i < size; ++i) vector << (Item)numbers[i] / 7;
+  }
+  return vector;
+}
+
+template <typename Item>
+void benchLegacyToString(Bench::Timer &timer) {
+  const Vector<Item> &vector = formatNumbers<Item>(timer.size());
+  timer.start();
+  string text = legacyToString(vector);
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(text.size());
+}
+
+template <typename Item>
+void benchToString(Bench::Timer &timer) {
+  const Vector<Item> &vector = formatNumbers<Item>(timer.size());
+  timer.start();
+  string text = vector.toString();
+  timer.stop();
+  timer.setItems(timer.size());
+  timer.setBytes(text.size());
+}
+
+template <typename Item>
+void benchPrintTo(Bench::Timer &timer) {
+  const Vector<Item> &vector = formatNumbers<Item>(timer.size());
+  static int fd = open("/dev/null", O_WRONLY);
+  timer.start();
+  vector.printTo(fd);
+  timer.stop();
+  timer.setItems(timer.size());
+}
+
+template <typename V>
+void benchCreateFillDestroy(Bench::Timer &timer) {
+  V vector;
+  for (int i = 0; i < timer.size(); ++i) vector << i;
+  timer.setItems(1);
+}
+
+/*
+ * a queue with a backlog of size items, from which 10000 items are taken
+ * at the front while new ones are added at the back
+ */
+void benchQueueVector(Bench::Timer &timer) {
+  Vector<int> queue;
+  queue.append(randomNumbers(timer.size()), timer.size());
+  long sum = 0;
+  timer.start();
+  for (int i = 0; i < 10000; ++i) {
+    sum += queue.removeAt(0);
+    queue << i;
+  }
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(10000);
+}
+
+void benchQueueDeque(Bench::Timer &timer) {
+  Deque<int> queue;
+  const int *numbers = randomNumbers(timer.size());
+  for (int i = 0; i < timer.size(); ++i) queue << numbers[i];
+  long sum = 0;
+  timer.start();
+  for (int i = 0; i < 10000; ++i) {
+    sum += queue.popFront();
+    queue << i;
+  }
+  timer.stop();
+  if (sum == 42) cout << endl;
+  timer.setItems(10000);
+}
+
+/// the number of lookups done by the lookup benchmarks
+const int LOOKUPS = 1000;
+
+void benchLookupIndex(Bench::Timer &timer) {
+  static Vector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(randomNumbers(timer.size()), timer.size());
+  }
+  const int *keys = randomNumbers(timer.size());
+  int found = 0;
+  timer.start();
+  for (int i = 0; i < LOOKUPS; ++i) {
+    found += vector.index(keys[(i * 7919) % timer.size()]) >= 0;
+  }
+  timer.stop();
+  timer.setItems(LOOKUPS);
+  if (found != LOOKUPS) abort();
+}
+
+void benchLookupIndexed(Bench::Timer &timer) {
+  static IndexedVector<int> vector(1);
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.append(VectorView<int>(randomNumbers(timer.size()), timer.size()));
+    vector.index(0);
+  }
+  const int *keys = randomNumbers(timer.size());
+  int found = 0;
+  timer.start();
+  for (int i = 0; i < LOOKUPS * 100; ++i) {
+    found += vector.index(keys[(i * 7919) % timer.size()]) >= 0;
+  }
+  timer.stop();
+  timer.setItems(LOOKUPS * 100);
+  if (found != LOOKUPS * 100) abort();
+}
+
+template <typename Search>
+void benchLookupSorted(Bench::Timer &timer) {
+  static SortedVector<int, int, less<int>, Search> vector;
+  if (vector.size() != timer.size()) {
+    vector.clear();
+    vector.insert(VectorView<int>(randomNumbers(timer.size()), timer.size()));
+    vector.find(0);
+  }
+  const int *keys = randomNumbers(timer.size());
+  int found = 0;
+  timer.start();
+  for (int i = 0; i < LOOKUPS * 100; ++i) {
+    found += vector.find(keys[(i * 7919) % timer.size()]) >= 0;
+  }
+  timer.stop();
+  timer.setItems(LOOKUPS * 100);
+  if (found != LOOKUPS * 100) abort();
+}
+
+void benchSortedInsertBatch(Bench::Timer &timer) {
+  SortedVector<int> vector;
+  vector.insert(VectorView<int>(randomNumbers(timer.size()), timer.size() / 2));
+  VectorView<int> batch(randomNumbers(timer.size()) + timer.size() / 2, timer.size() / 2);
+  timer.start();
+  vector.insert(batch);
+  timer.stop();
+  timer.setItems(batch.size());
+}
+
+void benchAppendSortBatch(Bench::Timer &timer) {
+  Vector<int> vector;
+  vector.append(randomNumbers(timer.size()), timer.size() / 2);
+  vector.sort(less<int>());
+  VectorView<int> batch(randomNumbers(timer.size()) + timer.size() / 2, timer.size() / 2);
+  timer.start();
+  vector.append(batch);
+  vector.sort(less<int>());
+  timer.stop();
+  timer.setItems(batch.size());
+}
+
+int main (int argc, char * const argv[]) {
+  Bench bench("Vector", 0.25);
+  
+  bench << Bench::Case("append", benchAppend, 1000);
+  bench << Bench::Case("append", benchAppend, 100000);
+  bench << Bench::Case("append", benchAppend, 1000000);
+  bench << Bench::Case("append reserved", benchAppendReserved, 1000000);
+  bench << Bench::Case("append SegmentedVector", benchAppendSegmented, 1000000);
+  bench << Bench::Case("grow append Vector", benchGrowVector, 16 << 20);
+  bench << Bench::Case("grow append SegmentedVector", benchGrowSegmented, 16 << 20);
+  bench << Bench::Case("append batches of 1000 <<", benchAppendBatches, 1000000);
+  bench << Bench::Case("append batches of 1000 bulk", benchAppendBulk, 1000000);
+  bench << Bench::Case("append strings <<", benchAppendStringCopies, 100000);
+  bench << Bench::Case("append strings emplace", benchAppendStringEmplace, 100000);
+  
+  bench << Bench::Case("index", benchIndex<Simd::AVX2>, 1000);
+  bench << Bench::Case("index", benchIndex<Simd::AVX2>, 1000000);
+  bench << Bench::Case("index sse2", benchIndex<Simd::SSE2>, 1000000);
+  bench << Bench::Case("index scalar", benchIndex<Simd::SCALAR>, 1000000);
+  bench << Bench::Case("count", benchCount, 1000000);
+  
+  bench << Bench::Case("sum at() loop", benchSumLoop, 1000000);
+  bench << Bench::Case("sum [] loop Checked", benchSumIndex<Checked>, 1000000);
+  bench << Bench::Case("sum [] loop Unchecked", benchSumIndex<Unchecked>, 1000000);
+  bench << Bench::Case("sum range for loop", benchSumRangeFor, 1000000);
+  bench << Bench::Case("sum+minmax int", benchAggregates<int, Simd::AVX2>, 1000);
+  bench << Bench::Case("sum+minmax int", benchAggregates<int, Simd::AVX2>, 1000000);
+  bench << Bench::Case("sum+minmax int sse2", benchAggregates<int, Simd::SSE2>, 1000000);
+  bench << Bench::Case("sum+minmax int scalar", benchAggregates<int, Simd::SCALAR>, 1000000);
+  bench << Bench::Case("sum+minmax float", benchAggregates<float, Simd::AVX2>, 1000000);
+  bench << Bench::Case("sum+minmax float scalar", benchAggregates<float, Simd::SCALAR>, 1000000);
+  bench << Bench::Case("sum+minmax double", benchAggregates<double, Simd::AVX2>, 1000000);
+  bench << Bench::Case("sum+minmax double scalar", benchAggregates<double, Simd::SCALAR>, 1000000);
+  
+  bench << Bench::Case("sort random radix", benchRadixSort, 1000);
+  bench << Bench::Case("sort random radix", benchRadixSort, 1000000);
+  bench << Bench::Case("sort random", benchSort<fillRandom>, 1000);
+  bench << Bench::Case("sort random", benchSort<fillRandom>, 1000000);
+  bench << Bench::Case("sort random lambda", benchSortLambda, 1000000);
+  bench << Bench::Case("sort sorted", benchSort<fillSorted>, 10000);
+  bench << Bench::Case("sort reversed", benchSort<fillReversed>, 10000);
+  bench << Bench::Case("sort organ pipe", benchSort<fillOrganPipe>, 10000);
+  bench << Bench::Case("sort few unique", benchSort<fillFewUnique>, 10000);
+  bench << Bench::Case("sort random", benchSort<fillRandom>, 10000);
+  // the legacy quicksort is quadratic and recurses N deep on sorted input
+  bench << Bench::Case("legacy sort sorted", benchLegacySort<fillSorted>, 10000);
+  bench << Bench::Case("legacy sort reversed", benchLegacySort<fillReversed>, 10000);
+  bench << Bench::Case("legacy sort organ pipe", benchLegacySort<fillOrganPipe>, 10000);
+  bench << Bench::Case("legacy sort few unique", benchLegacySort<fillFewUnique>, 10000);
+  bench << Bench::Case("legacy sort random", benchLegacySort<fillRandom>, 10000);
+  bench << Bench::Case("sortParallel 1 thread", benchSortParallel<1>, 1000000);
+  bench << Bench::Case("sortParallel 2 threads", benchSortParallel<2>, 1000000);
+  bench << Bench::Case("sortParallel 4 threads", benchSortParallel<4>, 1000000);
+  bench << Bench::Case("sortParallel shared pool", benchSortParallel<0>, 1000000);
+  
+  bench << Bench::Case("slice 10 windows", benchSlice, 1000);
+  bench << Bench::Case("slice 10 windows", benchSlice, 100000);
+  bench << Bench::Case("view 10 windows", benchView, 1000);
+  bench << Bench::Case("view 10 windows", benchView, 100000);
+  
+  bench << Bench::Case("pass by value+slice Vector", benchCopyVector, 1000000);
+  bench << Bench::Case("pass by value+slice SharedVector", benchCopySharedVector, 1000000);
+  
+  bench << Bench::Case("remove 50%", benchRemove, 10000);
+  bench << Bench::Case("remove 50%", benchRemove, 1000000);
+  bench << Bench::Case("legacy removeAt 50%", benchLegacyRemove, 10000);
+  
+  bench << Bench::Case("map function pointer", benchMap, 1000);
+  bench << Bench::Case("map function pointer", benchMap, 1000000);
+  bench << Bench::Case("map lambda", benchMapLambda, 1000);
+  bench << Bench::Case("map lambda", benchMapLambda, 1000000);
+  
+  bench << Bench::Case("map expensive", benchMapExpensive, 1000000);
+  bench << Bench::Case("parallelMap expensive 1 thread", benchParallelMap<1>, 1000000);
+  bench << Bench::Case("parallelMap expensive 2 threads", benchParallelMap<2>, 1000000);
+  bench << Bench::Case("parallelMap expensive 4 threads", benchParallelMap<4>, 1000000);
+  bench << Bench::Case("parallelMap expensive shared pool", benchParallelMap<0>, 1000000);
+  bench << Bench::Case("parallelReduce sum 1 thread", benchParallelReduce<1>, 10000000);
+  bench << Bench::Case("parallelReduce sum 2 threads", benchParallelReduce<2>, 10000000);
+  bench << Bench::Case("parallelReduce sum 4 threads", benchParallelReduce<4>, 10000000);
+  bench << Bench::Case("parallelReduce sum shared pool", benchParallelReduce<0>, 10000000);
+  
+  bench << Bench::Case("filter/map/sum copies", benchFilterMapSumCopies, 1000);
+  bench << Bench::Case("filter/map/sum copies", benchFilterMapSumCopies, 10000000);
+  bench << Bench::Case("filter/map/sum pipe", benchFilterMapSumPipe, 1000);
+  bench << Bench::Case("filter/map/sum pipe", benchFilterMapSumPipe, 10000000);
+  
+  bench << Bench::Case("churn malloc", benchMallocChurn, 1000);
+  bench << Bench::Case("churn arena", benchArenaChurn, 1000);
+  bench << Bench::Case("churn pool", benchPoolChurn, 1000);
+  
+  bench << Bench::Case("open+sum MappedVector", benchMappedOpen, 10000000);
+  bench << Bench::Case("open+sum read into Vector", benchReadOpen, 10000000);
+  
+  bench << Bench::Case("write+read binary", benchWriteReadBinary, 1000000);
+  bench << Bench::Case("write+read text", benchWriteReadText, 1000000);
+  
+  bench << Bench::Case("legacy toString int", benchLegacyToString<int>, 100);
+  bench << Bench::Case("toString int", benchToString<int>, 100);
+  bench << Bench::Case("legacy toString int", benchLegacyToString<int>, 1000000);
+  bench << Bench::Case("toString int", benchToString<int>, 1000000);
+  bench << Bench::Case("printTo int", benchPrintTo<int>, 1000000);
+  bench << Bench::Case("legacy toString double", benchLegacyToString<double>, 1000000);
+  bench << Bench::Case("toString double", benchToString<double>, 1000000);
+  
+  bench << Bench::Case("create/fill/destroy Vector",
+                       benchCreateFillDestroy<Vector<int> >, 0);
+  bench << Bench::Case("create/fill/destroy SmallVector<16>",
+                       benchCreateFillDestroy<SmallVector<int, 16> >, 0);
+  bench << Bench::Case("create/fill/destroy Vector",
+                       benchCreateFillDestroy<Vector<int> >, 16);
+  bench << Bench::Case("create/fill/destroy SmallVector<16>",
+                       benchCreateFillDestroy<SmallVector<int, 16> >, 16);
+  bench << Bench::Case("create/fill/destroy Vector",
+                       benchCreateFillDestroy<Vector<int> >, 64);
+  bench << Bench::Case("create/fill/destroy SmallVector<16>",
+                       benchCreateFillDestroy<SmallVector<int, 16> >, 64);
+  
+  bench << Bench::Case("queue Vector removeAt(0)", benchQueueVector, 1000);
+  bench << Bench::Case("queue Deque popFront", benchQueueDeque, 1000);
+  bench << Bench::Case("queue Vector removeAt(0)", benchQueueVector, 100000);
+  bench << Bench::Case("queue Deque popFront", benchQueueDeque, 100000);
+  
+  bench << Bench::Case("lookup Vector::index", benchLookupIndex, 1000000);
+  bench << Bench::Case("lookup IndexedVector", benchLookupIndexed, 1000);
+  bench << Bench::Case("lookup IndexedVector", benchLookupIndexed, 1000000);
+  bench << Bench::Case("lookup SortedVector binary",
+                       benchLookupSorted<BinarySearch<int> >, 1000);
+  bench << Bench::Case("lookup SortedVector branchless",
+                       benchLookupSorted<BranchlessSearch<int> >, 1000);
+  bench << Bench::Case("lookup SortedVector binary",
+                       benchLookupSorted<BinarySearch<int> >, 1000000);
+  bench << Bench::Case("lookup SortedVector branchless",
+                       benchLookupSorted<BranchlessSearch<int> >, 1000000);
+  bench << Bench::Case("lookup SortedVector eytzinger",
+                       benchLookupSorted<EytzingerSearch<int> >, 1000000);
+  bench << Bench::Case("insert batch SortedVector merge", benchSortedInsertBatch, 1000000);
+  bench << Bench::Case("insert batch append+sort", benchAppendSortBatch, 1000000);
+  
+  bench.run(argc, argv);
+  return 0;
+}
@@ -0,0 +1,390 @@
+/*
+ *  allocator.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_ALLOCATOR
+#define FOUNDATION_ALLOCATOR
+
+#include <cstdlib>
+#include <cstring>
+#include <stddef.h>
+
+namespace Foundation {
+  /**
+   * the allocator every container uses by default. It simply uses malloc,
+   * realloc and free. Every allocator has to provide the same three methods,
+   * the containers store a copy of the allocator they were created with.
+   */
+  class MallocAllocator {
+  public:
+    
+    void *allocate(size_t bytes) {
+      return malloc(bytes);
+    }
+    
+    void *reallocate(void *pointer, size_t, size_t newBytes) {
+      return realloc(pointer, newBytes);
+    }
+    
+    void deallocate(void *pointer, size_t) {
+      free(pointer);
+    }
+  };
+  
+  /**
+   * tells the containers if the memory of an allocator can be handed over
+   * to a copy of the allocator, which is how vectors are moved. This is
+   * true for all allocators that don't keep the memory in the allocator
+   * object itself, the others specialize it (see InlineAllocator).
+   */
+  template <typename Allocator>
+  struct AllocatorTraits {
+    static const bool transferable = true;
+  };
+  
+  /**
+   * a bump pointer arena. Allocations are taken from big blocks by moving a
+   * pointer forward, single allocations are never freed (except the latest
+   * one). All memory is released at once by reset() or the destructor.
+   * The arena is not thread safe.
+   */
+  class Arena {
+  private:
+    
+    struct Block {
+      Block *previous;
+      size_t size;
+    };
+    
+    /// the block the allocations are currently taken from
+    Block *current;
+    
+    /// the next free byte and the end of the current block
+    char *position;
+    char *limit;
+    
+    /// the start of the latest allocation, which can be grown or freed
+    char *latest;
+    
+    /// the minimum size of new blocks
+    size_t blockSize;
+    
+    /// the number of bytes that are currently allocated from the arena
+    size_t used;
+  
+  public:
+    
+    /// all allocations are aligned to this
+    static const size_t ALIGNMENT = 16;
+    
+    /**
+     * creates an empty arena, the first block is allocated on first use.
+     * @param blockSize the minimum size of the blocks that are allocated
+     */
+    Arena(size_t blockSize = 64 * 1024)
+    :current(NULL), position(NULL), limit(NULL), latest(NULL),
+     blockSize(blockSize), used(0)
+    {}
+    
+    ~Arena() {
+      this->release(NULL);
+    }
+    
+    /**
+     * returns aligned memory of the passed size from the arena
+     * @param bytes the number of bytes to allocate
+     */
+    void *allocate(size_t bytes) {
+      bytes = align(bytes);
+      if (this->position == NULL || (size_t)(this->limit - this->position) < bytes) {
+        if (!this->grow(bytes)) return NULL;
+      }
+      this->latest = this->position;
+      this->position += bytes;
+      this->used += bytes;
+      return this->latest;
+    }
+    
+    /**
+     * resizes an allocation. The latest allocation is resized in place if
+     * the block has enough space left, all others are copied.
+     */
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      if (pointer == NULL) return this->allocate(newBytes);
+      
+      if ((char *)pointer == this->latest &&
+          (size_t)(this->limit - this->latest) >= align(newBytes)) {
+        this->used += align(newBytes) - (this->position - this->latest);
+        this->position = this->latest + align(newBytes);
+        return pointer;
+      }
+      
+      void *moved = this->allocate(newBytes);
+      if (moved != NULL) {
+        memcpy(moved, pointer, oldBytes < newBytes ? oldBytes : newBytes);
+      }
+      return moved;
+    }
+    
+    /**
+     * frees an allocation. Only the latest allocation is given back to the
+     * arena, all other memory stays in use until reset.
+     */
+    void deallocate(void *pointer, size_t) {
+      if (pointer != NULL && (char *)pointer == this->latest) {
+        this->used -= this->position - this->latest;
+        this->position = this->latest;
+        this->latest = NULL;
+      }
+    }
+    
+    /**
+     * frees all allocations at once. The first block is kept for reuse.
+     */
+    void reset() {
+      Block *first = this->current;
+      while (first != NULL && first->previous != NULL) first = first->previous;
+      this->release(first);
+      
+      this->current = first;
+      this->position = first ? (char *)first + align(sizeof(Block)) : NULL;
+      this->limit = first ? (char *)first + first->size : NULL;
+      this->latest = NULL;
+      this->used = 0;
+    }
+    
+    /**
+     * returns the number of bytes that are allocated from the arena
+     */
+    size_t bytesUsed() const {
+      return this->used;
+    }
+  
+  protected:
+    
+    static size_t align(size_t bytes) {
+      return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+    
+    /**
+     * allocates a new block that has space for at least bytes
+     */
+    bool grow(size_t bytes) {
+      size_t header = align(sizeof(Block));
+      size_t size = bytes + header > this->blockSize ? bytes + header : this->blockSize;
+      Block *block = (Block *)malloc(size);
+      if (block == NULL) return false;
+      
+      block->previous = this->current;
+      block->size = size;
+      this->current = block;
+      this->position = (char *)block + header;
+      this->limit = (char *)block + size;
+      return true;
+    }
+    
+    /**
+     * frees all blocks except the passed one
+     */
+    void release(Block *keep) {
+      Block *block = this->current;
+      while (block != NULL) {
+        Block *previous = block->previous;
+        if (block != keep) free(block);
+        else block->previous = NULL;
+        block = previous;
+      }
+    }
+  };
+  
+  /**
+   * the allocator for containers that allocate from an arena. The arena has
+   * to live longer than the containers.
+   */
+  class ArenaAllocator {
+  private:
+    
+    Arena *arena;
+  
+  public:
+    
+    ArenaAllocator(Arena &arena)
+    :arena(&arena)
+    {}
+    
+    void *allocate(size_t bytes) {
+      return this->arena->allocate(bytes);
+    }
+    
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      return this->arena->reallocate(pointer, oldBytes, newBytes);
+    }
+    
+    void deallocate(void *pointer, size_t bytes) {
+      this->arena->deallocate(pointer, bytes);
+    }
+  };
+  
+  /**
+   * a pool of free lists for size classes of powers of two from 16 bytes to
+   * 64 KB. Freed memory is kept in the list of its class and reused by the
+   * next allocation of the class. Bigger allocations use malloc directly.
+   * The pool is not thread safe.
+   */
+  class Pool {
+  private:
+    
+    /// the free lists are linked through the freed memory
+    struct Node {
+      Node *next;
+    };
+    
+    static const int CLASSES = 13;
+    static const size_t SMALLEST = 16;
+    
+    /// the first free node of every size class
+    Node *freeLists[CLASSES];
+    
+    /// the number of bytes that are handed out by the pool
+    size_t used;
+  
+  public:
+    
+    /// allocations bigger than this are not pooled
+    static const size_t LARGEST = SMALLEST << (CLASSES - 1);
+    
+    Pool()
+    :used(0)
+    {
+      for (int i = 0; i < CLASSES; ++i) this->freeLists[i] = NULL;
+    }
+    
+    ~Pool() {
+      this->trim();
+    }
+    
+    /**
+     * returns memory of at least the passed size, from the free list of the
+     * size class if possible
+     */
+    void *allocate(size_t bytes) {
+      if (bytes > LARGEST) return malloc(bytes);
+      
+      int index = classOf(bytes);
+      this->used += SMALLEST << index;
+      Node *node = this->freeLists[index];
+      if (node != NULL) {
+        this->freeLists[index] = node->next;
+        return node;
+      }
+      return malloc(SMALLEST << index);
+    }
+    
+    /**
+     * resizes an allocation, which is free if the size class stays the same
+     */
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      if (pointer == NULL) return this->allocate(newBytes);
+      if (oldBytes > LARGEST && newBytes > LARGEST) {
+        return realloc(pointer, newBytes);
+      }
+      if (oldBytes <= LARGEST && newBytes <= LARGEST &&
+          classOf(oldBytes) == classOf(newBytes)) {
+        return pointer;
+      }
+      
+      void *moved = this->allocate(newBytes);
+      if (moved != NULL) {
+        memcpy(moved, pointer, oldBytes < newBytes ? oldBytes : newBytes);
+        this->deallocate(pointer, oldBytes);
+      }
+      return moved;
+    }
+    
+    /**
+     * puts the memory back to the free list of its size class
+     * @param bytes the size that was used to allocate the memory
+     */
+    void deallocate(void *pointer, size_t bytes) {
+      if (pointer == NULL) return;
+      if (bytes > LARGEST) {
+        free(pointer);
+        return;
+      }
+      
+      int index = classOf(bytes);
+      this->used -= SMALLEST << index;
+      Node *node = (Node *)pointer;
+      node->next = this->freeLists[index];
+      this->freeLists[index] = node;
+    }
+    
+    /**
+     * gives the memory of all free lists back to the system
+     */
+    void trim() {
+      for (int i = 0; i < CLASSES; ++i) {
+        while (this->freeLists[i] != NULL) {
+          Node *next = this->freeLists[i]->next;
+          free(this->freeLists[i]);
+          this->freeLists[i] = next;
+        }
+      }
+    }
+    
+    /**
+     * returns the number of bytes of pooled allocations that are in use
+     */
+    size_t bytesUsed() const {
+      return this->used;
+    }
+  
+  protected:
+    
+    /**
+     * returns the index of the smallest size class that fits bytes
+     */
+    static int classOf(size_t bytes) {
+      int index = 0;
+      size_t size = SMALLEST;
+      while (size < bytes) {
+        size <<= 1;
+        index++;
+      }
+      return index;
+    }
+  };
+  
+  /**
+   * the allocator for containers that allocate from a pool. The pool has
+   * to live longer than the containers.
+   */
+  class PoolAllocator {
+  private:
+    
+    Pool *pool;
+  
+  public:
+    
+    PoolAllocator(Pool &pool)
+    :pool(&pool)
+    {}
+    
+    void *allocate(size_t bytes) {
+      return this->pool->allocate(bytes);
+    }
+    
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      return this->pool->reallocate(pointer, oldBytes, newBytes);
+    }
+    
+    void deallocate(void *pointer, size_t bytes) {
+      this->pool->deallocate(pointer, bytes);
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ *  bench.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_BENCH
+#define FOUNDATION_BENCH
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Foundation {
+  /**
+   * a suite of benchmarks. Every benchmark case is a function that is called
+   * again and again, every call is one iteration. The suite warms the case
+   * up, chooses the number of iterations per sample so that a sample takes
+   * long enough for the clock and collects samples until the time of the
+   * case is used up. The report contains the min, median and p99 time per
+   * iteration and the items and bytes per second.
+   */
+  class Bench {
+  public:
+    
+    typedef std::chrono::steady_clock Clock;
+    
+    /**
+     * passed to every call of a case. The whole call is measured, unless
+     * the case calls start() and stop() around the part to measure (to
+     * leave the setup out).
+     */
+    class Timer {
+      friend class Bench;
+    
+    private:
+      
+      int benchSize;
+      long itemsPerCall, bytesPerCall;
+      bool running, used;
+      Clock::time_point started, callStarted;
+      Clock::duration elapsed;
+    
+    public:
+      
+      Timer(int size)
+      :benchSize(size), itemsPerCall(0), bytesPerCall(0),
+       running(false), used(false), elapsed(0)
+      {}
+      
+      /**
+       * returns the size the case should work on
+       */
+      int size() const {
+        return this->benchSize;
+      }
+      
+      /**
+       * starts measuring
+       */
+      void start() {
+        this->used = true;
+        this->running = true;
+        this->started = Clock::now();
+      }
+      
+      /**
+       * stops measuring
+       */
+      void stop() {
+        if (!this->running) return;
+        this->elapsed += Clock::now() - this->started;
+        this->running = false;
+      }
+      
+      /**
+       * sets the number of items that are processed per call
+       */
+      void setItems(long items) {
+        this->itemsPerCall = items;
+      }
+      
+      /**
+       * sets the number of bytes that are processed per call
+       */
+      void setBytes(long bytes) {
+        this->bytesPerCall = bytes;
+      }
+    
+    protected:
+      
+      void beginCall() {
+        this->used = false;
+        this->callStarted = Clock::now();
+      }
+      
+      void endCall() {
+        if (this->running) this->stop();
+        if (!this->used) this->elapsed += Clock::now() - this->callStarted;
+      }
+    };
+    
+    typedef void (*benchFunction)(Timer &timer);
+    
+    /**
+     * a benchmark case: a name, the function and the size it works on
+     */
+    struct Case {
+      const char * name;
+      benchFunction fn;
+      int size;
+      
+      Case(const char * name, benchFunction fn, int size = 0)
+      :name(name), fn(fn), size(size)
+      {}
+    };
+    
+    /**
+     * the measured times of a case in nanoseconds per iteration
+     */
+    struct Result {
+      std::string name;
+      int size;
+      long samples, iterations;
+      double min, median, p99;
+      double itemsPerSecond, bytesPerSecond;
+    };
+  
+  private:
+    
+    const char * name;
+    std::vector<Case> cases;
+    std::vector<Result> results;
+    
+    /// the time to warm up and to sample every case
+    double warmupSeconds, sampleSeconds;
+    
+    /// the min and max number of samples per case
+    long minSamples, maxSamples;
+  
+  public:
+    
+    Bench(const char * name, double sampleSeconds = 0.5)
+    :name(name), warmupSeconds(sampleSeconds / 5), sampleSeconds(sampleSeconds),
+     minSamples(5), maxSamples(1000)
+    {}
+    
+    /**
+     * add the passed case to the suite
+     */
+    void operator<<(const Case &benchCase) {
+      this->cases.push_back(benchCase);
+    }
+    
+    /**
+     * runs all cases of the suite and prints the results. If one of the
+     * arguments is --json followed by a path, the results are also written
+     * to this file as json. An argument without a dash only runs the cases
+     * whose name contains it.
+     */
+    void run(int argc = 0, char * const argv[] = NULL) {
+      const char *jsonPath = NULL;
+      const char *filter = NULL;
+      for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else filter = argv[i];
+      }
+      
+      std::cout << "Running benchmarks for " << this->name << std::endl;
+      std::cout << std::left << std::setw(44) << "case" << std::right
+                << std::setw(12) << "min" << std::setw(12) << "median"
+                << std::setw(12) << "p99" << std::setw(14) << "items/s"
+                << std::setw(12) << "MB/s" << std::endl;
+      
+      for (size_t i = 0; i < this->cases.size(); ++i) {
+        if (filter != NULL && strstr(this->cases[i].name, filter) == NULL) continue;
+        Result result = this->measure(this->cases[i]);
+        this->results.push_back(result);
+        this->print(result);
+      }
+      
+      if (jsonPath != NULL) {
+        std::ofstream json(jsonPath);
+        this->writeJson(json);
+        std::cout << "Results written to " << jsonPath << std::endl;
+      }
+    }
+    
+    /**
+     * writes the results of the last run as json
+     */
+    void writeJson(std::ostream &out) const {
+      out << "{\"suite\": \"" << escape(this->name) << "\", \"results\": [";
+      for (size_t i = 0; i < this->results.size(); ++i) {
+        const Result &result = this->results[i];
+        out << (i > 0 ? ",\n  " : "\n  ")
+            << "{\"name\": \"" << escape(result.name) << "\", "
+            << "\"size\": " << result.size << ", "
+            << "\"samples\": " << result.samples << ", "
+            << "\"iterations\": " << result.iterations << ", "
+            << "\"min_ns\": " << result.min << ", "
+            << "\"median_ns\": " << result.median << ", "
+            << "\"p99_ns\": " << result.p99 << ", "
+            << "\"items_per_second\": " << result.itemsPerSecond << ", "
+            << "\"bytes_per_second\": " << result.bytesPerSecond << "}";
+      }
+      out << "\n]}" << std::endl;
+    }
+  
+  protected:
+    
+    /**
+     * calls the case batch times and returns the measured time per call in
+     * ns, the wall time of the whole batch (setup included) is added to wall
+     */
+    static double sample(const Case &benchCase, Timer &timer, long batch, double &wall) {
+      Clock::time_point started = Clock::now();
+      timer.elapsed = Clock::duration(0);
+      for (long i = 0; i < batch; ++i) {
+        timer.beginCall();
+        benchCase.fn(timer);
+        timer.endCall();
+      }
+      wall += std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+      std::chrono::duration<double, std::nano> elapsed = timer.elapsed;
+      return elapsed.count() / batch;
+    }
+    
+    /**
+     * warms the case up, calibrates the batch size and collects the samples.
+     * The time limits are wall time, so cases with a long setup take fewer
+     * iterations instead of running much longer than asked.
+     */
+    Result measure(const Case &benchCase) {
+      Timer timer(benchCase.size);
+      
+      // warm up and find out how long a call takes
+      double warmup = this->warmupSeconds * 1e9;
+      double wall = 0;
+      long calls = 0;
+      double perCall;
+      do {
+        perCall = sample(benchCase, timer, 1, wall);
+        calls++;
+      } while (wall < warmup);
+      double wallPerCall = wall / calls;
+      
+      // a sample should take at least 1ms of measured time, but not more
+      // than its share of the budget of wall time
+      double budget = this->sampleSeconds * 1e9;
+      long batch = perCall > 0 ? (long)(1e6 / perCall) + 1 : 1000;
+      long wallBatch = (long)(budget / this->minSamples / wallPerCall);
+      if (batch > wallBatch) batch = wallBatch > 1 ? wallBatch : 1;
+      
+      std::vector<double> samples;
+      wall = 0;
+      while ((long)samples.size() < this->minSamples ||
+             (wall < budget && (long)samples.size() < this->maxSamples)) {
+        samples.push_back(sample(benchCase, timer, batch, wall));
+      }
+      std::sort(samples.begin(), samples.end());
+      
+      Result result;
+      result.name = benchCase.name;
+      result.size = benchCase.size;
+      result.samples = (long)samples.size();
+      result.iterations = batch * result.samples;
+      result.min = samples.front();
+      result.median = samples[samples.size() / 2];
+      size_t p99 = (size_t)(samples.size() * 0.99);
+      result.p99 = samples[p99 < samples.size() ? p99 : samples.size() - 1];
+      result.itemsPerSecond = timer.itemsPerCall * 1e9 / result.median;
+      result.bytesPerSecond = timer.bytesPerCall * 1e9 / result.median;
+      return result;
+    }
+    
+    /**
+     * prints a result as line of the report
+     */
+    static void print(const Result &result) {
+      std::ostringstream name;
+      name << result.name << " (" << result.size << ")";
+      std::cout << std::left << std::setw(44) << name.str() << std::right
+                << std::setw(12) << formatTime(result.min)
+                << std::setw(12) << formatTime(result.median)
+                << std::setw(12) << formatTime(result.p99)
+                << std::setw(14) << formatRate(result.itemsPerSecond)
+                << std::setw(12) << formatRate(result.bytesPerSecond / 1e6)
+                << std::endl;
+    }
+    
+    static std::string formatTime(double ns) {
+      std::ostringstream text;
+      text << std::fixed << std::setprecision(2);
+      if (ns < 1e3) text << ns << "ns";
+      else if (ns < 1e6) text << ns / 1e3 << "us";
+      else if (ns < 1e9) text << ns / 1e6 << "ms";
+      else text << ns / 1e9 << "s";
+      return text.str();
+    }
+    
+    static std::string formatRate(double rate) {
+      if (rate <= 0) return "-";
+      std::ostringstream text;
+      text << std::setprecision(4) << rate;
+      return text.str();
+    }
+    
+    static std::string escape(const std::string &text) {
+      std::string escaped;
+      for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '"' || text[i] == '\\') escaped += '\\';
+        escaped += text[i];
+      }
+      return escaped;
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,439 @@
+/*
+ *  deque.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_DEQUE
+#define FOUNDATION_DEQUE
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * a double ended queue on a ring buffer. Items are added and removed at
+   * both ends in O(1), unlike Vector::removeAt(0), which moves all other
+   * items. The capacity is a power of two, so the position of an item is
+   * (head + index) & mask. When the buffer is full it grows to the double
+   * size and the items are unwrapped, so that they start at 0 again.
+   *
+   * The api is the one of Vector: negative indexes count from the end and
+   * all accessors throw a VectorAccessException for indexes out of range.
+   * The items are not contiguous, see views().
+   */
+  template <typename Item, typename Index = int, typename Allocator = MallocAllocator>
+  class Deque {
+  private:
+    
+    /// the ring buffer, maxSize is always a power of two
+    Item *elements;
+    Index maxSize;
+    
+    /// the position of the first item in the ring buffer
+    Index head;
+    
+    Index elementsSize;
+    
+    Allocator allocator;
+  
+  public:
+    
+    /**
+     * initialize an empty deque
+     * @param size the initial capacity, which is rounded up to a power of two
+     * @param allocator the allocator to use for the ring buffer
+     */
+    Deque(Index size = 16, const Allocator &allocator = Allocator())
+    :elements(NULL), maxSize(1), head(0), elementsSize(0), allocator(allocator)
+    {
+      while (this->maxSize < size) this->maxSize *= 2;
+      this->elements = (Item *)this->allocator.allocate(this->bytes());
+    }
+    
+    Deque(const Deque<Item, Index, Allocator> &other)
+    :elements(NULL), maxSize(other.maxSize), head(0), elementsSize(0),
+     allocator(other.allocator)
+    {
+      this->elements = (Item *)this->allocator.allocate(this->bytes());
+      this->copyFrom(other);
+    }
+    
+    Deque<Item, Index, Allocator> &operator=(const Deque<Item, Index, Allocator> &other) {
+      if (this != &other) {
+        this->clear();
+        if (this->maxSize < other.elementsSize) {
+          this->allocator.deallocate(this->elements, this->bytes());
+          this->maxSize = other.maxSize;
+          this->elements = (Item *)this->allocator.allocate(this->bytes());
+        }
+        this->copyFrom(other);
+      }
+      return *this;
+    }
+    
+    ~Deque() {
+      this->clear();
+      this->allocator.deallocate(this->elements, this->bytes());
+    }
+    
+    /**
+     * returns the number of items in the deque
+     */
+    Index size() const {
+      return this->elementsSize;
+    }
+    
+    bool isEmpty() const {
+      return this->elementsSize == 0;
+    }
+    
+    /**
+     * returns the number of items the deque can hold before it has to grow
+     */
+    Index capacity() const {
+      return this->maxSize;
+    }
+    
+    /**
+     * returns the item at the passed index
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    Item &at(const Index index) {
+      return this->elements[this->position(this->indexFor(index))];
+    }
+    
+    const Item &at(const Index index) const {
+      return this->elements[this->position(this->indexFor(index))];
+    }
+    
+    Item &operator[](const Index index) {
+      return this->at(index);
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->at(index);
+    }
+    
+    /**
+     * returns the first item
+     * @throws VectorAccessException if the deque is empty
+     */
+    Item &first() {
+      return this->at(0);
+    }
+    
+    const Item &first() const {
+      return this->at(0);
+    }
+    
+    /**
+     * returns the last item
+     * @throws VectorAccessException if the deque is empty
+     */
+    Item &last() {
+      return this->at(-1);
+    }
+    
+    const Item &last() const {
+      return this->at(-1);
+    }
+    
+    /**
+     * adds the item at the end. O(1) amortized. The item may be an item of
+     * the deque, it is copied before the deque grows.
+     */
+    void pushBack(const Item &item) {
+      if (this->elementsSize == this->maxSize) {
+        this->pushBack(Item(item));
+        return;
+      }
+      new (this->elements + this->position(this->elementsSize)) Item(item);
+      this->elementsSize++;
+    }
+    
+    void pushBack(Item &&item) {
+      if (this->elementsSize == this->maxSize) {
+        Item moved(std::move(item));
+        this->grow();
+        new (this->elements + this->position(this->elementsSize)) Item(std::move(moved));
+      } else {
+        new (this->elements + this->position(this->elementsSize)) Item(std::move(item));
+      }
+      this->elementsSize++;
+    }
+    
+    /**
+     * adds the item in front of the first item. O(1) amortized. The item
+     * may be an item of the deque, like for pushBack.
+     */
+    void pushFront(const Item &item) {
+      if (this->elementsSize == this->maxSize) {
+        this->pushFront(Item(item));
+        return;
+      }
+      Index head = (this->head - 1) & (this->maxSize - 1);
+      new (this->elements + head) Item(item);
+      this->head = head;
+      this->elementsSize++;
+    }
+    
+    void pushFront(Item &&item) {
+      Index head;
+      if (this->elementsSize == this->maxSize) {
+        Item moved(std::move(item));
+        this->grow();
+        head = (this->head - 1) & (this->maxSize - 1);
+        new (this->elements + head) Item(std::move(moved));
+      } else {
+        head = (this->head - 1) & (this->maxSize - 1);
+        new (this->elements + head) Item(std::move(item));
+      }
+      this->head = head;
+      this->elementsSize++;
+    }
+    
+    /**
+     * adds an item at the end like pushBack
+     * @return self (the current deque) to enable chaining of <<
+     */
+    Deque<Item, Index, Allocator> &operator<<(const Item &item) {
+      this->pushBack(item);
+      return *this;
+    }
+    
+    Deque<Item, Index, Allocator> &operator<<(Item &&item) {
+      this->pushBack(std::move(item));
+      return *this;
+    }
+    
+    /**
+     * removes the first item. O(1)
+     * @return the item that was removed
+     * @throws VectorAccessException if the deque is empty
+     */
+    Item popFront() {
+      Item *element = this->elements + this->position(this->indexFor(0));
+      Item item = std::move(*element);
+      element->~Item();
+      this->head = (this->head + 1) & (this->maxSize - 1);
+      this->elementsSize--;
+      return item;
+    }
+    
+    /**
+     * removes the last item. O(1)
+     * @return the item that was removed
+     * @throws VectorAccessException if the deque is empty
+     */
+    Item popBack() {
+      Item *element = this->elements + this->position(this->indexFor(-1));
+      Item item = std::move(*element);
+      element->~Item();
+      this->elementsSize--;
+      return item;
+    }
+    
+    /**
+     * removes the item at the passed index, the items on the shorter side
+     * of it are moved. O(min(index, size - index))
+     * @param index the index of the item, negative means Nth item before end
+     * @return the item that was removed
+     */
+    Item removeAt(Index index) {
+      index = this->indexFor(index);
+      Item item = std::move(this->elements[this->position(index)]);
+      if (index < this->elementsSize / 2) {
+        for (Index i = index; i > 0; --i) {
+          this->elements[this->position(i)] = std::move(this->elements[this->position(i - 1)]);
+        }
+        this->elements[this->head].~Item();
+        this->head = (this->head + 1) & (this->maxSize - 1);
+      } else {
+        for (Index i = index; i < this->elementsSize - 1; ++i) {
+          this->elements[this->position(i)] = std::move(this->elements[this->position(i + 1)]);
+        }
+        this->elements[this->position(this->elementsSize - 1)].~Item();
+      }
+      this->elementsSize--;
+      return item;
+    }
+    
+    /**
+     * removes all items, the capacity is kept
+     */
+    void clear() {
+      if (!std::is_trivially_destructible<Item>::value) {
+        for (Index i = 0; i < this->elementsSize; ++i) {
+          this->elements[this->position(i)].~Item();
+        }
+      }
+      this->head = 0;
+      this->elementsSize = 0;
+    }
+    
+    /**
+     * returns the items as two views, the items from the head to the end
+     * of the ring buffer and the wrapped items from its start. The second
+     * view is empty if the items don't wrap around. The views are valid
+     * until the deque is changed.
+     */
+    std::pair<VectorView<Item, Index>, VectorView<Item, Index> > views() const {
+      Index front = std::min(this->elementsSize, this->maxSize - this->head);
+      return std::make_pair(VectorView<Item, Index>(this->elements + this->head, front),
+                            VectorView<Item, Index>(this->elements, this->elementsSize - front));
+    }
+    
+    /**
+     * returns the position of the first occurance of the item or -1
+     */
+    Index index(const Item &item) const {
+      std::pair<VectorView<Item, Index>, VectorView<Item, Index> > views = this->views();
+      Index index = views.first.index(item);
+      if (index >= 0) return index;
+      index = views.second.index(item);
+      return index >= 0 ? views.first.size() + index : -1;
+    }
+    
+    /**
+     * returns the position of the last occurance of the item or -1
+     */
+    Index lastIndex(const Item &item) const {
+      std::pair<VectorView<Item, Index>, VectorView<Item, Index> > views = this->views();
+      Index index = views.second.lastIndex(item);
+      if (index >= 0) return views.first.size() + index;
+      return views.first.lastIndex(item);
+    }
+    
+    bool contains(const Item &item) const {
+      return this->index(item) >= 0;
+    }
+    
+    /**
+     * returns a vector with a copy of the items from the start index to the
+     * end, like Vector::slice
+     * @param start the start index, may be negative
+     */
+    Vector<Item, Index> slice(const Index start) const {
+      return this->slice(start, this->elementsSize - this->indexFor(start));
+    }
+    
+    /**
+     * returns a vector with a copy of size items from the start index
+     * @param start the start index, may be negative
+     * @param size the number of items in the new vector
+     * @throws VectorAccessException if the range is out of the deque
+     */
+    Vector<Item, Index> slice(const Index start, const Index size) const {
+      Index begin = this->indexFor(start);
+      Index end = this->indexFor(start + size - 1);
+      if (end < begin) {
+        throw VectorAccessException<Item, Index>(this->elementsSize, end);
+      }
+      
+      // the range is copied in at most two pieces
+      Vector<Item, Index> slice(size);
+      Index position = this->position(begin);
+      Index front = std::min(size, this->maxSize - position);
+      slice.append(this->elements + position, front);
+      slice.append(this->elements, size - front);
+      return slice;
+    }
+    
+    /**
+     * returns a string representation of the deque
+     */
+    std::string inspect() const {
+      std::string details;
+      Format::StringSink sink(details);
+      if (this->head + this->elementsSize <= this->maxSize) {
+        Format::details(sink, "Foundation::Deque", this, this->elements + this->head,
+                        (size_t)this->elementsSize);
+      } else {
+        Vector<Item, Index> items = this->slice(0, this->elementsSize);
+        Format::details(sink, "Foundation::Deque", this, items.begin(),
+                        (size_t)items.size());
+      }
+      return details;
+    }
+    
+    /**
+     * returns a string representation of the items in order
+     */
+    std::string toString() const {
+      std::pair<VectorView<Item, Index>, VectorView<Item, Index> > views = this->views();
+      if (views.second.size() == 0) return views.first.toString();
+      return this->slice(0, this->elementsSize).toString();
+    }
+  
+  private:
+    
+    /**
+     * returns the position in the ring buffer of the item at index, which
+     * must be in [0, size]
+     */
+    inline Index position(Index index) const {
+      return (this->head + index) & (this->maxSize - 1);
+    }
+    
+    inline Index indexFor(Index index) const {
+      return Checked::index<Item, Index>(index, this->elementsSize);
+    }
+    
+    inline size_t bytes() const {
+      return (size_t)this->maxSize * sizeof(Item);
+    }
+    
+    /**
+     * doubles the capacity and moves the items to the start of the new
+     * ring buffer, in order
+     */
+    void grow() {
+      Index maxSize = this->maxSize * 2;
+      Item *elements = (Item *)this->allocator.allocate((size_t)maxSize * sizeof(Item));
+      Index front = std::min(this->elementsSize, this->maxSize - this->head);
+      this->relocate(elements, this->elements + this->head, front);
+      this->relocate(elements + front, this->elements, this->elementsSize - front);
+      this->allocator.deallocate(this->elements, this->bytes());
+      this->elements = elements;
+      this->maxSize = maxSize;
+      this->head = 0;
+    }
+    
+    /**
+     * moves size items to uninitialized memory, which is a memcpy for
+     * trivial items
+     */
+    static void relocate(Item *to, Item *from, Index size) {
+      if (std::is_trivially_copyable<Item>::value) {
+        if (size > 0) memcpy((void *)to, (const void *)from, (size_t)size * sizeof(Item));
+        return;
+      }
+      for (Index i = 0; i < size; ++i) {
+        new (to + i) Item(std::move_if_noexcept(from[i]));
+        from[i].~Item();
+      }
+    }
+    
+    /**
+     * copies the items of the other deque to the empty deque, which must
+     * have space for them
+     */
+    void copyFrom(const Deque<Item, Index, Allocator> &other) {
+      for (Index i = 0; i < other.elementsSize; ++i) {
+        new (this->elements + i) Item(other.elements[other.position(i)]);
+      }
+      this->head = 0;
+      this->elementsSize = other.elementsSize;
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+ *  format.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_FORMAT
+#define FOUNDATION_FORMAT
+
+#include <charconv>
+#include <limits>
+#include <sstream>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include "serialization.h"
+
+namespace Foundation {
+  /**
+   * the text format of vectors, like "{1, 2, 3}". Numbers are written with
+   * std::to_chars into a buffer on the stack, which is passed to a sink in
+   * big pieces. This avoids the locale and allocations of a stream. The
+   * text is the same as the one of a std::ostream with default settings,
+   * all other items (like strings or chars) are still written by a stream.
+   *
+   * A sink is any object with an append(const char *text, size_t size)
+   * method, for example a StringSink or a FileSink.
+   */
+  namespace Format {
+    /**
+     * true for the items that are written using to_chars. Characters and
+     * bools are written as text by a stream, so they take the slow path.
+     */
+    template <typename Item>
+    struct IsNumber {
+      typedef typename std::remove_cv<Item>::type Type;
+      static const bool value = std::is_arithmetic<Type>::value &&
+        !std::is_same<Type, bool>::value && !std::is_same<Type, char>::value &&
+        !std::is_same<Type, signed char>::value &&
+        !std::is_same<Type, unsigned char>::value &&
+        !std::is_same<Type, wchar_t>::value &&
+        !std::is_same<Type, char16_t>::value &&
+        !std::is_same<Type, char32_t>::value;
+    };
+    
+    /// the max number of chars of one number
+    const size_t MAX_NUMBER = 48;
+    
+    /// the size of the buffer on the stack, which is passed to the sink
+    const size_t BUFFER = 4096;
+    
+    /**
+     * appends the text to a string
+     */
+    class StringSink {
+    private:
+      
+      std::string &text;
+    
+    public:
+      
+      StringSink(std::string &text)
+      :text(text)
+      {}
+      
+      inline void append(const char *text, size_t size) {
+        this->text.append(text, size);
+      }
+    };
+    
+    /**
+     * writes the text to a file descriptor. The text is written by the
+     * format in pieces of BUFFER bytes, so the sink doesn't buffer.
+     */
+    class FileSink {
+    private:
+      
+      int fd;
+    
+    public:
+      
+      FileSink(int fd)
+      :fd(fd)
+      {}
+      
+      /**
+       * @throws SerializationException if the write fails
+       */
+      inline void append(const char *text, size_t size) {
+        struct iovec buffer;
+        buffer.iov_base = (void *)text;
+        buffer.iov_len = size;
+        Serialization::writeAll(this->fd, &buffer, 1);
+      }
+    };
+    
+    /**
+     * writes the number to the buffer, which must have space for
+     * MAX_NUMBER chars. Floating point numbers are written like %g with 6
+     * digits, which is the default of a stream.
+     * @return the end of the number
+     */
+    template <typename Number>
+    inline char *number(char *buffer, Number number, std::false_type) {
+      return std::to_chars(buffer, buffer + MAX_NUMBER, number).ptr;
+    }
+    
+    template <typename Number>
+    inline char *number(char *buffer, Number number, std::true_type) {
+      return std::to_chars(buffer, buffer + MAX_NUMBER, number,
+                           std::chars_format::general, 6).ptr;
+    }
+    
+    template <typename Number>
+    inline char *number(char *buffer, Number number) {
+      return Format::number(buffer, number,
+                            typename std::is_floating_point<Number>::type());
+    }
+    
+    /**
+     * writes the items like "{1, 2, 3}" to the sink
+     */
+    template <typename Sink, typename Item>
+    void values(Sink &sink, const Item *items, size_t size, std::true_type) {
+      char buffer[BUFFER];
+      char *position = buffer;
+      *position++ = '{';
+      for (size_t i = 0; i < size; ++i) {
+        if (position + MAX_NUMBER + 3 > buffer + BUFFER) {
+          sink.append(buffer, position - buffer);
+          position = buffer;
+        }
+        if (i > 0) {
+          *position++ = ',';
+          *position++ = ' ';
+        }
+        position = Format::number(position, items[i]);
+      }
+      *position++ = '}';
+      sink.append(buffer, position - buffer);
+    }
+    
+    template <typename Sink, typename Item>
+    void values(Sink &sink, const Item *items, size_t size, std::false_type) {
+      std::ostringstream values;
+      values << "{";
+      for (size_t i = 0; i < size; ++i) {
+        values << items[i];
+        if (i != size - 1) {
+          values << ", ";
+        }
+      }
+      values << "}";
+      std::string text = values.str();
+      sink.append(text.data(), text.size());
+    }
+    
+    template <typename Sink, typename Item>
+    inline void values(Sink &sink, const Item *items, size_t size) {
+      Format::values(sink, items, size,
+                     std::integral_constant<bool, IsNumber<Item>::value>());
+    }
+    
+    /**
+     * writes the details like "<Foundation::Vector#0x1234 size:3 values:{1,
+     * 2, 3}>" to the sink, the address is written like a stream does
+     * @param name the name of the class
+     * @param object the address of the object
+     */
+    template <typename Sink, typename Item>
+    void details(Sink &sink, const char *name, const void *object,
+                 const Item *items, size_t size) {
+      char buffer[128];
+      char *position = buffer;
+      *position++ = '<';
+      size_t length = std::min(strlen(name), (size_t)64);
+      memcpy(position, name, length);
+      position += length;
+      *position++ = '#';
+      if (object == NULL) {
+        *position++ = '0';
+      } else {
+        *position++ = '0';
+        *position++ = 'x';
+        position = std::to_chars(position, buffer + sizeof(buffer),
+                                 (uintptr_t)object, 16).ptr;
+      }
+      memcpy(position, " size:", 6);
+      position = Format::number(position + 6, size);
+      memcpy(position, " values:", 8);
+      sink.append(buffer, position + 8 - buffer);
+      Format::values(sink, items, size);
+      sink.append(">", 1);
+    }
+    
+    /**
+     * returns the size a string should reserve for the text of size items,
+     * which is exact for small numbers and slightly too big for others
+     */
+    template <typename Item>
+    inline size_t estimate(size_t size) {
+      if (!IsNumber<Item>::value) return 0;
+      size_t digits = std::is_floating_point<Item>::value ? 8 :
+        std::min<size_t>(std::numeric_limits<Item>::digits10 + 1, 6);
+      return 2 + size * (digits + 2);
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,394 @@
+/*
+ *  indexedvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_INDEXEDVECTOR
+#define FOUNDATION_INDEXEDVECTOR
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * an open addressing hash table (linear probing) from the items of a
+   * vector to the positions of their first and last occurance. The table
+   * doesn't copy the items, an entry only stores the positions and the
+   * item is compared with the item at the first position. The table is at
+   * most half full, so a lookup needs about 1.5 probes.
+   */
+  template <typename Item, typename Index = int, typename Hash = std::hash<Item>,
+            typename Equal = std::equal_to<Item> >
+  class HashIndex {
+  private:
+    
+    struct Entry {
+      /// the first and last position of the item, -1 for an empty entry
+      Index first;
+      Index last;
+    };
+    
+    Vector<Entry, Index> entries;
+    Index used;
+    Hash hash;
+    Equal equal;
+  
+  public:
+    
+    HashIndex()
+    :entries(1), used(0)
+    {}
+    
+    /**
+     * returns true if the table has entries for the items
+     */
+    bool isBuilt() const {
+      return this->entries.size() > 0;
+    }
+    
+    /**
+     * returns the bytes of the table
+     */
+    size_t bytes() const {
+      return (size_t)this->entries.size() * sizeof(Entry);
+    }
+    
+    /**
+     * removes all entries and frees the table
+     */
+    void clear() {
+      this->entries = Vector<Entry, Index>(1);
+      this->used = 0;
+    }
+    
+    /**
+     * adds all items to a new table. O(N)
+     */
+    void build(const Item *items, Index size) {
+      Index capacity = 16;
+      while (capacity < size * 2) capacity *= 2;
+      this->resize(items, capacity);
+      for (Index i = 0; i < size; ++i) this->add(items, i);
+    }
+    
+    /**
+     * adds the item at the position, which must be behind all positions
+     * in the table
+     */
+    void add(const Item *items, Index position) {
+      if ((this->used + 1) * 2 > this->entries.size()) {
+        this->resize(items, this->entries.size() * 2);
+      }
+      Entry &entry = this->entryFor(items, items[position]);
+      if (entry.first < 0) {
+        entry.first = position;
+        this->used++;
+      }
+      entry.last = position;
+    }
+    
+    /**
+     * returns the first position of the item or -1. O(1)
+     */
+    Index first(const Item *items, const Item &item) const {
+      return this->entryFor(items, item).first;
+    }
+    
+    /**
+     * returns the last position of the item or -1. O(1)
+     */
+    Index last(const Item *items, const Item &item) const {
+      const Entry &entry = this->entryFor(items, item);
+      return entry.first < 0 ? -1 : entry.last;
+    }
+  
+  private:
+    
+    /**
+     * returns the entry of the item or the empty entry where it belongs.
+     * The hash is spread by a multiplication, as std::hash of integers
+     * returns the integer itself.
+     */
+    inline const Entry &entryFor(const Item *items, const Item &item) const {
+      const Entry *entries = this->entries.begin();
+      size_t mask = (size_t)this->entries.size() - 1;
+      size_t slot = (size_t)(((uint64_t)this->hash(item) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+      while (entries[slot].first >= 0 && !this->equal(items[entries[slot].first], item)) {
+        slot = (slot + 1) & mask;
+      }
+      return entries[slot];
+    }
+    
+    inline Entry &entryFor(const Item *items, const Item &item) {
+      return const_cast<Entry &>(static_cast<const HashIndex *>(this)->entryFor(items, item));
+    }
+    
+    /**
+     * moves the entries to a new table with capacity entries
+     */
+    void resize(const Item *items, Index capacity) {
+      Vector<Entry, Index> old = this->entries;
+      Entry empty = { -1, -1 };
+      this->entries = Vector<Entry, Index>(capacity);
+      this->entries.fill(empty, capacity);
+      for (Index i = 0; i < old.size(); ++i) {
+        const Entry &entry = old.begin()[i];
+        if (entry.first >= 0) this->entryFor(items, items[entry.first]) = entry;
+      }
+    }
+  };
+  
+  /**
+   * a vector for items that are searched much more often than changed.
+   * index, lastIndex and contains use a HashIndex, which is built by the
+   * first search and then found in O(1) instead of a linear scan. Items
+   * appended by << are added to the index, all other changes (removeAt,
+   * sort, reverse, map, ...) drop it and the next search builds it again.
+   * The index needs indexBytes() extra memory, about 4 * sizeof(Index)
+   * bytes per distinct item.
+   *
+   * The items can only be changed through the methods of the vector, so
+   * that the index stays valid. Items need a Hash and an Equal, like the
+   * keys of a std::unordered_map. The first search after a change builds
+   * the index, so it must not run in parallel to other searches.
+   */
+  template <typename Item, typename Index = int, typename Hash = std::hash<Item>,
+            typename Equal = std::equal_to<Item> >
+  class IndexedVector {
+  private:
+    
+    Vector<Item, Index> items;
+    
+    /// built by the first search
+    mutable HashIndex<Item, Index, Hash, Equal> hashIndex;
+  
+  public:
+    
+    typedef Item (*mappingFunction)(const Item);
+    typedef int (*compareFunction)(const Item &left, const Item &right);
+    
+    /**
+     * initialize an empty vector
+     * @param size the first initial max size for the vector
+     */
+    IndexedVector(Index size = 10)
+    :items(size)
+    {}
+    
+    /**
+     * initialize the vector with a copy of the items
+     */
+    IndexedVector(const VectorView<Item, Index> &items)
+    :items(items.size() > 0 ? items.size() : 1)
+    {
+      this->items.append(items);
+    }
+    
+    Index size() const {
+      return this->items.size();
+    }
+    
+    bool isEmpty() const {
+      return this->items.isEmpty();
+    }
+    
+    /**
+     * returns a view on the items
+     */
+    VectorView<Item, Index> view() const {
+      return this->items.view();
+    }
+    
+    /**
+     * returns a lazy pipe over the items, see Pipe
+     */
+    Pipe<PipeSource<Item>, Index> pipe() const {
+      return this->items.view().pipe();
+    }
+    
+    const Item *begin() const {
+      return this->items.begin();
+    }
+    
+    const Item *end() const {
+      return this->items.end();
+    }
+    
+    /**
+     * returns the item at the passed index
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    const Item &at(const Index index) const {
+      return this->items.at(index);
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->items.at(index);
+    }
+    
+    const Item &first() const {
+      return this->items.view().first();
+    }
+    
+    const Item &last() const {
+      return this->items.view().last();
+    }
+    
+    /**
+     * returns the position of the first occurance of the item or -1. O(1)
+     * once the index is built
+     */
+    Index index(const Item &item) const {
+      return this->search().first(this->items.begin(), item);
+    }
+    
+    /**
+     * returns the position of the last occurance of the item or -1. O(1)
+     * once the index is built
+     */
+    Index lastIndex(const Item &item) const {
+      return this->search().last(this->items.begin(), item);
+    }
+    
+    /**
+     * returns true if the item is in the vector
+     */
+    bool contains(const Item &item) const {
+      return this->index(item) >= 0;
+    }
+    
+    /**
+     * returns the number of items that are equal to item. O(N)
+     */
+    Index count(const Item &item) const {
+      return this->items.count(item);
+    }
+    
+    /**
+     * returns true if the index is built
+     */
+    bool isIndexed() const {
+      return this->hashIndex.isBuilt();
+    }
+    
+    /**
+     * returns the bytes used by the index, 0 if it isn't built
+     */
+    size_t indexBytes() const {
+      return this->hashIndex.bytes();
+    }
+    
+    /**
+     * appends the item and adds it to the index, if it is built
+     * @return self (the current vector) to enable chaining of <<
+     */
+    IndexedVector<Item, Index, Hash, Equal> &operator<<(const Item &item) {
+      this->items << item;
+      if (this->hashIndex.isBuilt()) {
+        this->hashIndex.add(this->items.begin(), this->items.size() - 1);
+      }
+      return *this;
+    }
+    
+    /**
+     * appends the items and adds them to the index, if it is built
+     */
+    IndexedVector<Item, Index, Hash, Equal> &append(const VectorView<Item, Index> &items) {
+      Index size = this->items.size();
+      this->items.append(items);
+      if (this->hashIndex.isBuilt()) {
+        for (Index i = size; i < this->items.size(); ++i) {
+          this->hashIndex.add(this->items.begin(), i);
+        }
+      }
+      return *this;
+    }
+    
+    /**
+     * replaces the item at the passed index
+     */
+    void set(const Index index, const Item &item) {
+      this->items[index] = item;
+      this->hashIndex.clear();
+    }
+    
+    Item removeAt(const Index index) {
+      Item item = this->items.removeAt(index);
+      this->hashIndex.clear();
+      return item;
+    }
+    
+    template <typename Predicate>
+    Index removeIf(Predicate predicate) {
+      Index removed = this->items.removeIf(predicate);
+      if (removed > 0) this->hashIndex.clear();
+      return removed;
+    }
+    
+    void clear() {
+      this->items.clear();
+      this->hashIndex.clear();
+    }
+    
+    void reverse() {
+      this->items.reverse();
+      this->hashIndex.clear();
+    }
+    
+    void sort(compareFunction fn = defaultCompare) {
+      this->items.sort(fn);
+      this->hashIndex.clear();
+    }
+    
+    template <typename Compare>
+    void sort(Compare compare) {
+      this->items.sort(compare);
+      this->hashIndex.clear();
+    }
+    
+    void map(mappingFunction fn) {
+      this->items.map(fn);
+      this->hashIndex.clear();
+    }
+    
+    template <typename Mapping>
+    void map(Mapping fn) {
+      this->items.map(fn);
+      this->hashIndex.clear();
+    }
+    
+    /**
+     * returns a string representation of the vector
+     */
+    std::string inspect() const {
+      std::string details;
+      Format::StringSink sink(details);
+      Format::details(sink, "Foundation::IndexedVector", this, this->items.begin(),
+                      (size_t)this->items.size());
+      return details;
+    }
+    
+    std::string toString() const {
+      return this->items.toString();
+    }
+  
+  private:
+    
+    /**
+     * returns the index and builds it if needed
+     */
+    inline const HashIndex<Item, Index, Hash, Equal> &search() const {
+      if (!this->hashIndex.isBuilt()) {
+        this->hashIndex.build(this->items.begin(), this->items.size());
+      }
+      return this->hashIndex;
+    }
+  };
+};
+
+#endif
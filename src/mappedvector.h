@@ -0,0 +1,418 @@
+/*
+ *  mappedvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_MAPPEDVECTOR
+#define FOUNDATION_MAPPEDVECTOR
+
+#include <errno.h>
+#include <fcntl.h>
+#include <memory>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * thrown if a mapped file can't be opened, grown or mapped or if it has
+   * the wrong format
+   */
+  class MappedFileException : public std::exception {
+  private:
+    
+    std::string msg;
+  
+  public:
+    
+    MappedFileException(const std::string &path, const std::string &reason)
+    :std::exception(), msg("Mapped file " + path + ": " + reason)
+    {}
+    
+    virtual ~MappedFileException() throw() {}
+    
+    virtual const char* what() const throw() {
+      return this->msg.c_str();
+    }
+  };
+  
+  /**
+   * a file that is mapped into memory. The file starts with a header that
+   * holds the item size and the number of items, followed by the items.
+   * The mapping is handed out by allocate like the inline space of the
+   * InlineAllocator: only one allocation at a time is served from the file,
+   * all others use malloc. The file never shrinks.
+   */
+  class MappedFile {
+  public:
+    
+    /// the access patterns that can be passed to the kernel (madvise)
+    enum Access { NORMAL, SEQUENTIAL, RANDOM, WILLNEED };
+    
+    /// the size of the header, the items start behind it
+    static const size_t HEADER = 64;
+  
+  private:
+    
+    struct Header {
+      char magic[8];
+      uint32_t version;
+      uint32_t itemSize;
+      uint64_t count;
+    };
+    
+    std::string path;
+    int fd;
+    
+    /// the size of the file
+    size_t fileSize;
+    
+    /// the start and size of the mapping, NULL if the file isn't mapped
+    char *base;
+    size_t mapped;
+    
+    /// the access pattern of the mapping, which is kept for remaps
+    Access access;
+    
+    /// the number of items if the file isn't mapped
+    uint64_t itemCount;
+    
+    MappedFile(const MappedFile &other);
+    MappedFile &operator=(const MappedFile &other);
+  
+  public:
+    
+    /**
+     * opens the file, which is created if it doesn't exist
+     * @param path the path of the file
+     * @param itemSize the size of the items, which has to match the size
+     *                 the file was created with
+     * @throws MappedFileException if the file can't be opened, has another
+     *                             version or was created for other items
+     */
+    MappedFile(const char *path, size_t itemSize)
+    :path(path), fd(-1), fileSize(0), base(NULL), mapped(0), access(NORMAL),
+     itemCount(0)
+    {
+      this->fd = open(path, O_RDWR | O_CREAT, 0644);
+      if (this->fd < 0) this->fail("can't be opened");
+      
+      // the destructor doesn't run if the constructor throws
+      try {
+        struct stat status;
+        if (fstat(this->fd, &status) != 0) this->fail("can't be read");
+        this->fileSize = (size_t)status.st_size;
+        
+        Header header;
+        if (this->fileSize == 0) {
+          memset(&header, 0, sizeof(header));
+          memcpy(header.magic, "FNDVEC1", 8);
+          header.version = 1;
+          header.itemSize = (uint32_t)itemSize;
+          if (pwrite(this->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+              ftruncate(this->fd, HEADER) != 0) {
+            this->fail("can't be initialized");
+          }
+          this->fileSize = HEADER;
+        } else if (this->fileSize < HEADER ||
+                   pread(this->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+                   memcmp(header.magic, "FNDVEC1", 8) != 0) {
+          this->fail("is no mapped vector", 0);
+        } else if (header.version != 1) {
+          this->fail("has an unknown version", 0);
+        } else if (header.itemSize != itemSize) {
+          this->fail("was created for items of another size", 0);
+        }
+        this->itemCount = header.count;
+      } catch (...) {
+        close(this->fd);
+        throw;
+      }
+    }
+    
+    ~MappedFile() {
+      if (this->base != NULL) munmap(this->base, this->mapped);
+      if (this->fd >= 0) close(this->fd);
+    }
+    
+    /**
+     * maps the file, which grows to hold at least bytes of items. The file
+     * is mapped as a whole, so the space may be bigger than bytes. If the
+     * file is already mapped, the memory is taken from malloc.
+     */
+    void *allocate(size_t bytes) {
+      if (this->base != NULL) return malloc(bytes);
+      
+      size_t size = std::max(this->fileSize, HEADER + bytes);
+      this->grow(size);
+      void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+      if (base == MAP_FAILED) this->fail("can't be mapped");
+      
+      this->base = (char *)base;
+      this->mapped = size;
+      ((Header *)this->base)->count = this->itemCount;
+      this->advise(this->access);
+      return this->base + HEADER;
+    }
+    
+    /**
+     * grows the file and the mapping, the items stay in the file
+     */
+    void *reallocate(void *pointer, size_t, size_t newBytes) {
+      if (pointer == NULL) return this->allocate(newBytes);
+      if (!this->isMapped(pointer)) return realloc(pointer, newBytes);
+      
+      size_t size = HEADER + newBytes;
+      if (size <= this->mapped) return pointer;
+      
+      this->grow(size);
+#ifdef MREMAP_MAYMOVE
+      void *base = mremap(this->base, this->mapped, size, MREMAP_MAYMOVE);
+#else
+      munmap(this->base, this->mapped);
+      void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+#endif
+      if (base == MAP_FAILED) this->fail("can't be remapped");
+      
+      this->base = (char *)base;
+      this->mapped = size;
+      this->advise(this->access);
+      return this->base + HEADER;
+    }
+    
+    /**
+     * unmaps the file (the items stay in the file) or frees the memory
+     */
+    void deallocate(void *pointer, size_t) {
+      if (!this->isMapped(pointer)) {
+        free(pointer);
+        return;
+      }
+      this->itemCount = this->count();
+      munmap(this->base, this->mapped);
+      this->base = NULL;
+      this->mapped = 0;
+    }
+    
+    /**
+     * returns true if the pointer points to the items in the mapping
+     */
+    bool isMapped(const void *pointer) const {
+      return this->base != NULL && pointer == (const void *)(this->base + HEADER);
+    }
+    
+    /**
+     * returns the number of bytes of items that fit into the mapping
+     */
+    size_t capacity() const {
+      return this->mapped > HEADER ? this->mapped - HEADER : 0;
+    }
+    
+    /**
+     * returns the number of items that is stored in the header
+     */
+    uint64_t count() const {
+      return this->base != NULL ? ((Header *)this->base)->count : this->itemCount;
+    }
+    
+    /**
+     * stores the number of items in the header
+     */
+    void setCount(uint64_t count) {
+      if (this->base != NULL) ((Header *)this->base)->count = count;
+      this->itemCount = count;
+    }
+    
+    /**
+     * tells the kernel how the items will be accessed, so that it can read
+     * ahead (SEQUENTIAL), stop reading ahead (RANDOM) or read the whole
+     * file right now (WILLNEED)
+     */
+    void advise(Access access) {
+      this->access = access;
+      if (this->base == NULL) return;
+      
+      int advice = MADV_NORMAL;
+      if (access == SEQUENTIAL) advice = MADV_SEQUENTIAL;
+      else if (access == RANDOM) advice = MADV_RANDOM;
+      else if (access == WILLNEED) advice = MADV_WILLNEED;
+      madvise(this->base, this->mapped, advice);
+    }
+    
+    /**
+     * writes the changed pages to the file and waits until they are written
+     */
+    void sync() {
+      if (this->base != NULL && msync(this->base, this->mapped, MS_SYNC) != 0) {
+        this->fail("can't be written");
+      }
+    }
+  
+  protected:
+    
+    /**
+     * makes the file at least size bytes big, rounded up to whole pages
+     */
+    void grow(size_t size) {
+      size_t page = (size_t)sysconf(_SC_PAGESIZE);
+      size = (size + page - 1) / page * page;
+      if (size <= this->fileSize) return;
+      if (ftruncate(this->fd, (off_t)size) != 0) this->fail("can't grow");
+      this->fileSize = size;
+    }
+    
+    /**
+     * throws the exception, error is the errno of the failed call or 0
+     */
+    void fail(const char *reason, int error = errno) {
+      std::string message(reason);
+      if (error != 0) message += std::string(" (") + strerror(error) + ")";
+      throw MappedFileException(this->path, message);
+    }
+  };
+  
+  /**
+   * the allocator for vectors that keep their items in a mapped file. Only
+   * the allocator of the MappedVector maps the file (see map()), copies of
+   * the allocator share the file but use the heap. So copies and slices of
+   * the vector never write to the file, even if they outlive the vector.
+   */
+  class MappedAllocator {
+  private:
+    
+    std::shared_ptr<MappedFile> mappedFile;
+    
+    /// true if this allocator hands out the mapping
+    bool mapping;
+  
+  public:
+    
+    MappedAllocator(const char *path, size_t itemSize)
+    :mappedFile(new MappedFile(path, itemSize)), mapping(false)
+    {}
+    
+    MappedAllocator(const MappedAllocator &other)
+    :mappedFile(other.mappedFile), mapping(false)
+    {}
+    
+    /**
+     * maps the file, all later allocations of this allocator are mapped
+     * like the first one
+     * @return the items in the file
+     */
+    void *map() {
+      this->mapping = true;
+      return this->mappedFile->allocate(0);
+    }
+    
+    void *allocate(size_t bytes) {
+      if (!this->mapping) return malloc(bytes);
+      return this->mappedFile->allocate(bytes);
+    }
+    
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      if (!this->mapping) return realloc(pointer, newBytes);
+      return this->mappedFile->reallocate(pointer, oldBytes, newBytes);
+    }
+    
+    void deallocate(void *pointer, size_t bytes) {
+      if (!this->mapping) {
+        free(pointer);
+        return;
+      }
+      this->mappedFile->deallocate(pointer, bytes);
+    }
+    
+    MappedFile &file() const {
+      return *this->mappedFile;
+    }
+  
+  private:
+    
+    MappedAllocator &operator=(const MappedAllocator &other);
+  };
+  
+  /**
+   * only the allocator of the MappedVector may hold the mapping, so moved
+   * vectors move their items to the heap
+   */
+  template <>
+  struct AllocatorTraits<MappedAllocator> {
+    static const bool transferable = false;
+  };
+  
+  /**
+   * a vector that keeps its items in a memory mapped file. Opening the
+   * vector maps the file, the items are read lazily by the kernel when
+   * they are accessed, so opening is fast for any size. The vector grows
+   * by growing the file. The number of items is written to the file by
+   * sync() and when the vector is destroyed, the items survive restarts.
+   * The api is the same as the one of Vector, but the items have to be
+   * trivially copyable (they are stored as bytes). Copies and slices are
+   * normal vectors on the heap, views point into the mapping.
+   */
+  template <typename Item, typename Index = int>
+  class MappedVector : public Vector<Item, Index, MappedAllocator> {
+    static_assert(std::is_trivially_copyable<Item>::value,
+                  "mapped items have to be trivially copyable");
+  
+  public:
+    
+    typedef Vector<Item, Index, MappedAllocator> Base;
+    
+    /**
+     * opens the vector stored in the file, an empty vector is created if
+     * the file doesn't exist
+     * @param path the path of the file
+     * @throws MappedFileException if the file can't be opened or is not a
+     *                             vector of this item type
+     */
+    MappedVector(const char *path)
+    :Base(0, MappedAllocator(path, sizeof(Item)))
+    {
+      this->deallocateElements(this->bytes());
+      this->elements = (Item *)this->allocator.map();
+      MappedFile &file = this->allocator.file();
+      this->maxSize = (Index)(file.capacity() / sizeof(Item));
+      this->elementsSize = (Index)std::min<uint64_t>(file.count(), this->maxSize);
+    }
+    
+    /**
+     * writes the number of items to the file
+     */
+    ~MappedVector() {
+      this->allocator.file().setCount(this->elementsSize);
+    }
+    
+    /**
+     * tells the kernel how the items will be accessed
+     * @param access SEQUENTIAL for scans, RANDOM for lookups or WILLNEED to
+     *               read all items right now
+     */
+    void advise(MappedFile::Access access) {
+      this->allocator.file().advise(access);
+    }
+    
+    /**
+     * writes the number of items and all changed items to the file and
+     * waits until they are written
+     */
+    void sync() {
+      this->allocator.file().setCount(this->elementsSize);
+      this->allocator.file().sync();
+    }
+  
+  private:
+    
+    MappedVector(const MappedVector<Item, Index> &other);
+    MappedVector<Item, Index> &operator=(const MappedVector<Item, Index> &other);
+  };
+};
+
+#endif
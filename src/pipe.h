@@ -0,0 +1,275 @@
+/*
+ *  pipe.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_PIPE
+#define FOUNDATION_PIPE
+
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+
+namespace Foundation {
+  struct Checked;
+  
+  template <typename Item, typename Index, typename Allocator, typename Bounds>
+  class Vector;
+  
+  /**
+   * the first stage of every pipe, it passes the elements of a vector (or
+   * view) to the next stage. Every stage has a run method that passes all
+   * of its items to the sink, the stages are nested into each other at
+   * compile time so that the whole pipe becomes a single loop.
+   */
+  template <typename Item>
+  class PipeSource {
+  public:
+    
+    /// the type of the items passed to the sink
+    typedef Item Output;
+    
+    /// true if the stage passes exactly sizeHint() items
+    static const bool SIZED = true;
+  
+  private:
+    
+    const Item *elements;
+    size_t elementsSize;
+  
+  public:
+    
+    PipeSource(const Item *elements, size_t size)
+    :elements(elements), elementsSize(size)
+    {}
+    
+    template <typename Sink>
+    void run(Sink &sink) {
+      const Item *elements = this->elements;
+      for (size_t i = 0; i < this->elementsSize; ++i) {
+        sink(elements[i]);
+      }
+    }
+    
+    /**
+     * returns the max number of items that are passed to the sink
+     */
+    size_t sizeHint() const {
+      return this->elementsSize;
+    }
+  };
+  
+  /**
+   * passes only the items of the stage to the sink for which the predicate
+   * returns true
+   */
+  template <typename Stage, typename Predicate>
+  class PipeFilter {
+  public:
+    
+    typedef typename Stage::Output Output;
+    static const bool SIZED = false;
+  
+  private:
+    
+    Stage stage;
+    Predicate predicate;
+    
+    template <typename Sink>
+    struct Step {
+      Predicate &predicate;
+      Sink &sink;
+      
+      inline void operator()(const Output &item) {
+        if (this->predicate(item)) this->sink(item);
+      }
+    };
+  
+  public:
+    
+    PipeFilter(const Stage &stage, Predicate predicate)
+    :stage(stage), predicate(predicate)
+    {}
+    
+    template <typename Sink>
+    void run(Sink &sink) {
+      Step<Sink> step = { this->predicate, sink };
+      this->stage.run(step);
+    }
+    
+    size_t sizeHint() const {
+      return this->stage.sizeHint();
+    }
+  };
+  
+  /**
+   * passes the result of the mapping for every item of the stage to the
+   * sink. The mapping may return another type than it takes.
+   */
+  template <typename Stage, typename Mapping>
+  class PipeMap {
+  public:
+    
+    typedef typename std::decay<decltype(std::declval<Mapping &>()(
+      std::declval<const typename Stage::Output &>()))>::type Output;
+    static const bool SIZED = Stage::SIZED;
+  
+  private:
+    
+    Stage stage;
+    Mapping mapping;
+    
+    template <typename Sink>
+    struct Step {
+      Mapping &mapping;
+      Sink &sink;
+      
+      inline void operator()(const typename Stage::Output &item) {
+        this->sink(this->mapping(item));
+      }
+    };
+  
+  public:
+    
+    PipeMap(const Stage &stage, Mapping mapping)
+    :stage(stage), mapping(mapping)
+    {}
+    
+    template <typename Sink>
+    void run(Sink &sink) {
+      Step<Sink> step = { this->mapping, sink };
+      this->stage.run(step);
+    }
+    
+    size_t sizeHint() const {
+      return this->stage.sizeHint();
+    }
+  };
+  
+  /**
+   * a lazy chain of operations on the items of a vector. filter and map
+   * only add a stage to the pipe, nothing is done until the pipe is
+   * consumed by reduce, collect, forEach or count. All stages are fused
+   * into one pass over the items without any intermediate vectors:
+   *
+   *   long sum = vector.pipe().filter(isEven).map(square).reduce(0L, add);
+   *
+   * The pipe keeps a pointer to the elements of the vector, so it is only
+   * valid as long as the vector isn't changed in size or destroyed.
+   */
+  template <typename Stage, typename Index = int>
+  class Pipe {
+  public:
+    
+    /// the type of the items that come out of the pipe
+    typedef typename Stage::Output Item;
+  
+  private:
+    
+    Stage stage;
+    
+    template <typename Result, typename Operation>
+    struct ReduceSink {
+      Result &result;
+      Operation &operation;
+      
+      inline void operator()(const Item &item) {
+        this->result = this->operation(std::move(this->result), item);
+      }
+    };
+    
+    template <typename Target>
+    struct CollectSink {
+      Target &target;
+      
+      inline void operator()(const Item &item) {
+        this->target.emplace(item);
+      }
+    };
+    
+    struct CountSink {
+      Index count;
+      
+      inline void operator()(const Item &) {
+        this->count++;
+      }
+    };
+  
+  public:
+    
+    Pipe(const Stage &stage)
+    :stage(stage)
+    {}
+    
+    /**
+     * adds a stage that drops all items for which the predicate returns
+     * false
+     * @param predicate the callable that takes an item and returns a bool
+     */
+    template <typename Predicate>
+    Pipe<PipeFilter<Stage, Predicate>, Index> filter(Predicate predicate) const {
+      return Pipe<PipeFilter<Stage, Predicate>, Index>(
+        PipeFilter<Stage, Predicate>(this->stage, predicate));
+    }
+    
+    /**
+     * adds a stage that replaces every item with the result of the mapping
+     * @param mapping the callable that takes an item and returns the new one
+     */
+    template <typename Mapping>
+    Pipe<PipeMap<Stage, Mapping>, Index> map(Mapping mapping) const {
+      return Pipe<PipeMap<Stage, Mapping>, Index>(
+        PipeMap<Stage, Mapping>(this->stage, mapping));
+    }
+    
+    /**
+     * combines all items that come out of the pipe, from first to last
+     * @param initial the result for an empty pipe
+     * @param operation the callable that takes the result so far and an
+     *                  item and returns the new result
+     * @return the result after the last item
+     */
+    template <typename Result, typename Operation>
+    Result reduce(Result initial, Operation operation) {
+      ReduceSink<Result, Operation> sink = { initial, operation };
+      this->stage.run(sink);
+      return initial;
+    }
+    
+    /**
+     * returns a new vector with all items that come out of the pipe. Pipes
+     * without filter allocate the vector once.
+     */
+    Vector<Item, Index, MallocAllocator, Checked> collect() {
+      size_t hint = this->stage.sizeHint();
+      Vector<Item, Index, MallocAllocator, Checked> vector(
+        Stage::SIZED && hint > 0 ? (Index)hint : 10);
+      CollectSink<Vector<Item, Index, MallocAllocator, Checked> > sink = { vector };
+      this->stage.run(sink);
+      return vector;
+    }
+    
+    /**
+     * calls the function for every item that comes out of the pipe
+     * @param function the callable that takes an item
+     */
+    template <typename Function>
+    void forEach(Function function) {
+      this->stage.run(function);
+    }
+    
+    /**
+     * returns the number of items that come out of the pipe
+     */
+    Index count() {
+      CountSink sink = { 0 };
+      this->stage.run(sink);
+      return sink.count;
+    }
+  };
+};
+
+#endif
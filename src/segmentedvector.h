@@ -0,0 +1,431 @@
+/*
+ *  segmentedvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SEGMENTEDVECTOR
+#define FOUNDATION_SEGMENTEDVECTOR
+
+#include <algorithm>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * a vector that stores its items in chunks of 2^ChunkBits items, which
+   * are found through a directory of chunk pointers. Growing allocates a
+   * new chunk and at most copies the directory, the items are never moved.
+   * This avoids the copy of all items (and the double memory while doing
+   * it) that a Vector needs when it grows. References to the items stay
+   * valid across appends, only removeAt moves the items behind the index.
+   *
+   * The item at index i is in chunk i >> ChunkBits at i & (CHUNK_SIZE - 1),
+   * so access is O(1) with one more indirection than a Vector. Negative
+   * indexes count from the end and all accessors throw a
+   * VectorAccessException for indexes out of range. The items are not
+   * contiguous, see chunk().
+   */
+  template <typename Item, typename Index = int, int ChunkBits = 12,
+            typename Allocator = MallocAllocator>
+  class SegmentedVector {
+  public:
+    
+    /// the number of items in a chunk
+    static const Index CHUNK_SIZE = (Index)1 << ChunkBits;
+  
+  private:
+    
+    /// the directory with a pointer to every allocated chunk
+    Vector<Item *, Index> chunks;
+    
+    Index elementsSize;
+    
+    /// the next free item and the end of its chunk, so that appends don't
+    /// have to look up the chunk
+    Item *tail;
+    Item *tailEnd;
+    
+    Allocator allocator;
+  
+  public:
+    
+    /**
+     * initialize an empty vector, chunks are allocated on first use
+     * @param allocator the allocator to use for the chunks
+     */
+    SegmentedVector(const Allocator &allocator = Allocator())
+    :chunks(4), elementsSize(0), tail(NULL), tailEnd(NULL), allocator(allocator)
+    {}
+    
+    SegmentedVector(const SegmentedVector<Item, Index, ChunkBits, Allocator> &other)
+    :chunks(other.chunks.size() > 0 ? other.chunks.size() : 1), elementsSize(0),
+     tail(NULL), tailEnd(NULL), allocator(other.allocator)
+    {
+      this->copyFrom(other);
+    }
+    
+    SegmentedVector<Item, Index, ChunkBits, Allocator> &operator=(
+        const SegmentedVector<Item, Index, ChunkBits, Allocator> &other) {
+      if (this != &other) {
+        this->clear();
+        this->copyFrom(other);
+      }
+      return *this;
+    }
+    
+    ~SegmentedVector() {
+      this->clear();
+      this->release();
+    }
+    
+    /**
+     * returns the size of the vector
+     */
+    Index size() const {
+      return this->elementsSize;
+    }
+    
+    bool isEmpty() const {
+      return this->elementsSize == 0;
+    }
+    
+    /**
+     * returns the number of items the allocated chunks can hold
+     */
+    Index capacity() const {
+      return this->chunks.size() * CHUNK_SIZE;
+    }
+    
+    /**
+     * returns the item at the passed index
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    Item &at(const Index index) {
+      return this->element(this->indexFor(index));
+    }
+    
+    const Item &at(const Index index) const {
+      return this->element(this->indexFor(index));
+    }
+    
+    Item &operator[](const Index index) {
+      return this->at(index);
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->at(index);
+    }
+    
+    /**
+     * returns the first item
+     * @throws VectorAccessException if the vector is empty
+     */
+    Item &first() {
+      return this->at(0);
+    }
+    
+    const Item &first() const {
+      return this->at(0);
+    }
+    
+    /**
+     * returns the last item
+     * @throws VectorAccessException if the vector is empty
+     */
+    Item &last() {
+      return this->at(-1);
+    }
+    
+    const Item &last() const {
+      return this->at(-1);
+    }
+    
+    /**
+     * constructs an item in place at the end of the vector
+     * @param args the arguments for the constructor of the item
+     * @return the new item, which stays at its address
+     */
+    template <typename... Args>
+    Item &emplace(Args&&... args) {
+      if (this->tail == this->tailEnd) this->nextChunk();
+      Item *item = new (this->tail) Item(std::forward<Args>(args)...);
+      this->tail++;
+      this->elementsSize++;
+      return *item;
+    }
+    
+    /**
+     * adds an item to the vector
+     * @return self (the current vector) to enable chaining of <<
+     */
+    SegmentedVector<Item, Index, ChunkBits, Allocator> &operator<<(const Item &item) {
+      this->emplace(item);
+      return *this;
+    }
+    
+    SegmentedVector<Item, Index, ChunkBits, Allocator> &operator<<(Item &&item) {
+      this->emplace(std::move(item));
+      return *this;
+    }
+    
+    /**
+     * appends copies of the items, chunk by chunk
+     */
+    SegmentedVector<Item, Index, ChunkBits, Allocator> &append(const Item *array, Index size) {
+      while (size > 0) {
+        if (this->elementsSize == this->capacity()) this->addChunk();
+        Index offset = this->elementsSize & (CHUNK_SIZE - 1);
+        Index count = std::min(size, CHUNK_SIZE - offset);
+        std::uninitialized_copy(array, array + count,
+                                this->chunks.begin()[this->elementsSize >> ChunkBits] + offset);
+        this->elementsSize += count;
+        array += count;
+        size -= count;
+      }
+      this->updateTail();
+      return *this;
+    }
+    
+    SegmentedVector<Item, Index, ChunkBits, Allocator> &append(const VectorView<Item, Index> &items) {
+      return this->append(items.begin(), items.size());
+    }
+    
+    /**
+     * allocates the chunks for size items
+     */
+    void reserve(const Index size) {
+      while (this->capacity() < size) this->addChunk();
+      this->updateTail();
+    }
+    
+    /**
+     * removes the item at the passed index, all items behind it are moved
+     * one to the front. O(N)
+     * @return the item that was removed
+     */
+    Item removeAt(Index index) {
+      index = this->indexFor(index);
+      Item item = std::move(this->element(index));
+      for (Index i = index + 1; i < this->elementsSize; ++i) {
+        this->element(i - 1) = std::move(this->element(i));
+      }
+      this->element(this->elementsSize - 1).~Item();
+      this->elementsSize--;
+      this->updateTail();
+      return item;
+    }
+    
+    /**
+     * removes the last item. O(1)
+     * @return the item that was removed
+     * @throws VectorAccessException if the vector is empty
+     */
+    Item pop() {
+      Item *element = &this->at(-1);
+      Item item = std::move(*element);
+      element->~Item();
+      this->elementsSize--;
+      this->updateTail();
+      return item;
+    }
+    
+    /**
+     * removes all items, the chunks are kept
+     */
+    void clear() {
+      if (!std::is_trivially_destructible<Item>::value) {
+        for (Index i = 0; i < this->elementsSize; ++i) this->element(i).~Item();
+      }
+      this->elementsSize = 0;
+      this->updateTail();
+    }
+    
+    /**
+     * gives all chunks that have no items back to the allocator
+     */
+    void compact() {
+      Index used = (this->elementsSize + CHUNK_SIZE - 1) >> ChunkBits;
+      while (this->chunks.size() > used) {
+        this->allocator.deallocate(this->chunks.last(), CHUNK_SIZE * sizeof(Item));
+        this->chunks.removeAt(-1);
+      }
+      this->updateTail();
+    }
+    
+    /**
+     * returns the number of chunks with items
+     */
+    Index chunkCount() const {
+      return (this->elementsSize + CHUNK_SIZE - 1) >> ChunkBits;
+    }
+    
+    /**
+     * returns a view on the items of the chunk, which are contiguous. The
+     * view is valid until the items of the chunk are removed.
+     * @param index the index of the chunk, in [0, chunkCount())
+     */
+    VectorView<Item, Index> chunk(const Index index) const {
+      Index chunk = Checked::index<Item, Index>(index, this->chunkCount());
+      Index size = this->elementsSize - (chunk << ChunkBits);
+      if (size > CHUNK_SIZE) size = CHUNK_SIZE;
+      return VectorView<Item, Index>(this->chunks.begin()[chunk], size);
+    }
+    
+    /**
+     * returns the position of the first occurance of the item or -1
+     */
+    Index index(const Item &item) const {
+      for (Index i = 0; i < this->chunkCount(); ++i) {
+        Index index = this->chunk(i).index(item);
+        if (index >= 0) return (i << ChunkBits) + index;
+      }
+      return -1;
+    }
+    
+    /**
+     * returns the position of the last occurance of the item or -1
+     */
+    Index lastIndex(const Item &item) const {
+      for (Index i = this->chunkCount() - 1; i >= 0; --i) {
+        Index index = this->chunk(i).lastIndex(item);
+        if (index >= 0) return (i << ChunkBits) + index;
+      }
+      return -1;
+    }
+    
+    bool contains(const Item &item) const {
+      return this->index(item) >= 0;
+    }
+    
+    /**
+     * returns a vector with a copy of the items from the start index to the
+     * end, like Vector::slice
+     * @param start the start index, may be negative
+     */
+    Vector<Item, Index> slice(const Index start) const {
+      return this->slice(start, this->elementsSize - this->indexFor(start));
+    }
+    
+    /**
+     * returns a vector with a copy of size items from the start index
+     * @param start the start index, may be negative
+     * @param size the number of items in the new vector
+     * @throws VectorAccessException if the range is out of the vector
+     */
+    Vector<Item, Index> slice(const Index start, const Index size) const {
+      Index begin = this->indexFor(start);
+      Index end = this->indexFor(start + size - 1);
+      if (end < begin) {
+        throw VectorAccessException<Item, Index>(this->elementsSize, end);
+      }
+      
+      Vector<Item, Index> slice(size);
+      for (Index i = begin; i <= end; ) {
+        Index offset = i & (CHUNK_SIZE - 1);
+        Index count = std::min(end + 1 - i, CHUNK_SIZE - offset);
+        slice.append(this->chunks.begin()[i >> ChunkBits] + offset, count);
+        i += count;
+      }
+      return slice;
+    }
+    
+    /**
+     * returns a string representation of the vector
+     */
+    std::string inspect() const {
+      std::string details;
+      Format::StringSink sink(details);
+      if (this->elementsSize <= CHUNK_SIZE) {
+        Format::details(sink, "Foundation::SegmentedVector", this,
+                        this->elementsSize > 0 ? this->chunks.begin()[0] : (Item *)NULL,
+                        (size_t)this->elementsSize);
+      } else {
+        Vector<Item, Index> items = this->slice(0);
+        Format::details(sink, "Foundation::SegmentedVector", this, items.begin(),
+                        (size_t)items.size());
+      }
+      return details;
+    }
+    
+    /**
+     * returns a string representation of the items
+     */
+    std::string toString() const {
+      if (this->elementsSize == 0) return VectorView<Item, Index>().toString();
+      if (this->elementsSize <= CHUNK_SIZE) return this->chunk(0).toString();
+      return this->slice(0).toString();
+    }
+  
+  private:
+    
+    inline Item &element(Index index) {
+      return this->chunks.begin()[index >> ChunkBits][index & (CHUNK_SIZE - 1)];
+    }
+    
+    inline const Item &element(Index index) const {
+      return this->chunks.begin()[index >> ChunkBits][index & (CHUNK_SIZE - 1)];
+    }
+    
+    inline Index indexFor(Index index) const {
+      return Checked::index<Item, Index>(index, this->elementsSize);
+    }
+    
+    /**
+     * points the tail to the item behind the last one, or to NULL if all
+     * chunks are full
+     */
+    void updateTail() {
+      // unsigned, so that the compiler knows the chunk isn't negative
+      size_t chunk = (size_t)this->elementsSize >> ChunkBits;
+      if (chunk < (size_t)this->chunks.size()) {
+        this->tail = this->chunks.begin()[chunk] + (this->elementsSize & (CHUNK_SIZE - 1));
+        this->tailEnd = this->chunks.begin()[chunk] + CHUNK_SIZE;
+      } else {
+        this->tail = this->tailEnd = NULL;
+      }
+    }
+    
+    /**
+     * moves the tail to the next chunk, which is allocated if needed
+     */
+    FOUNDATION_COLD void nextChunk() {
+      if (this->elementsSize == this->capacity()) this->addChunk();
+      this->updateTail();
+    }
+    
+    /**
+     * allocates a new chunk, only the directory is copied when it grows
+     */
+    void addChunk() {
+      Item *chunk = (Item *)this->allocator.allocate(CHUNK_SIZE * sizeof(Item));
+      if (chunk == NULL) throw std::bad_alloc();
+      this->chunks << chunk;
+    }
+    
+    /**
+     * gives all chunks back to the allocator
+     */
+    void release() {
+      for (Index i = 0; i < this->chunks.size(); ++i) {
+        this->allocator.deallocate(this->chunks.begin()[i], CHUNK_SIZE * sizeof(Item));
+      }
+      this->chunks.clear();
+      this->updateTail();
+    }
+    
+    /**
+     * copies the items of the other vector behind the items of this one
+     */
+    void copyFrom(const SegmentedVector<Item, Index, ChunkBits, Allocator> &other) {
+      for (Index i = 0; i < other.chunkCount(); ++i) this->append(other.chunk(i));
+    }
+  };
+};
+
+#endif
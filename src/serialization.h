@@ -0,0 +1,348 @@
+/*
+ *  serialization.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SERIALIZATION
+#define FOUNDATION_SERIALIZATION
+
+#include <algorithm>
+#include <errno.h>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/uio.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace Foundation {
+  template <typename Item, typename Index>
+  class VectorView;
+  
+  /**
+   * thrown if a vector can't be written or read or the data is no vector
+   * of the expected items
+   */
+  class SerializationException : public std::exception {
+  private:
+    
+    std::string msg;
+  
+  public:
+    
+    SerializationException(const std::string &reason, int error = 0)
+    :std::exception(), msg("Serialized vector " + reason)
+    {
+      if (error != 0) this->msg += std::string(" (") + strerror(error) + ")";
+    }
+    
+    virtual ~SerializationException() throw() {}
+    
+    virtual const char* what() const throw() {
+      return this->msg.c_str();
+    }
+  };
+  
+  /**
+   * the binary format of vectors. A vector is written as a header followed
+   * by the bytes of the items, so only trivially copyable items can be
+   * written. The items are written in the byte order of the machine, the
+   * header records it, so that a reader on another machine fails instead
+   * of reading garbage.
+   */
+  namespace Serialization {
+    /// the version of the format
+    const uint32_t VERSION = 1;
+    
+    /// the byte order mark, which reads 0x04030201 on the other byte order
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    
+    /// the bytes that are read at once by default
+    const size_t CHUNK_BYTES = 64 * 1024;
+    
+    struct Header {
+      char magic[8];
+      uint32_t version;
+      uint32_t byteOrder;
+      uint32_t itemSize;
+      uint32_t reserved;
+      uint64_t count;
+      uint64_t checksum;
+    };
+    
+    /**
+     * a 64 bit checksum of a stream of bytes in the style of xxhash. Four
+     * independent lanes consume 32 bytes per round, so it runs at memory
+     * speed. The bytes may be passed in pieces of any size, the checksum
+     * is the same.
+     */
+    class Checksum {
+    private:
+      
+      static const uint64_t PRIME1 = 11400714785074694791ULL;
+      static const uint64_t PRIME2 = 14029467366897019727ULL;
+      static const uint64_t PRIME3 = 1609587929392839161ULL;
+      
+      uint64_t lanes[4];
+      
+      /// the bytes of the last incomplete round
+      unsigned char pending[32];
+      size_t pendingSize;
+      
+      uint64_t length;
+    
+    public:
+      
+      Checksum()
+      :pendingSize(0), length(0)
+      {
+        this->lanes[0] = PRIME1 + PRIME2;
+        this->lanes[1] = PRIME2;
+        this->lanes[2] = 0;
+        this->lanes[3] = 0 - PRIME1;
+      }
+      
+      /**
+       * adds the bytes to the checksum
+       */
+      void update(const void *data, size_t size) {
+        const unsigned char *bytes = (const unsigned char *)data;
+        this->length += size;
+        
+        if (this->pendingSize > 0) {
+          size_t missing = std::min(size, sizeof(this->pending) - this->pendingSize);
+          memcpy(this->pending + this->pendingSize, bytes, missing);
+          this->pendingSize += missing;
+          bytes += missing;
+          size -= missing;
+          if (this->pendingSize < sizeof(this->pending)) return;
+          this->round(this->pending);
+          this->pendingSize = 0;
+        }
+        
+        for (; size >= 32; bytes += 32, size -= 32) this->round(bytes);
+        memcpy(this->pending, bytes, size);
+        this->pendingSize = size;
+      }
+      
+      /**
+       * returns the checksum of all bytes so far
+       */
+      uint64_t value() const {
+        uint64_t hash = rotate(this->lanes[0], 1) + rotate(this->lanes[1], 7) +
+                        rotate(this->lanes[2], 12) + rotate(this->lanes[3], 18);
+        hash += this->length;
+        for (size_t i = 0; i < this->pendingSize; ++i) {
+          hash = rotate(hash ^ (this->pending[i] * PRIME3), 11) * PRIME1;
+        }
+        hash ^= hash >> 33;
+        hash *= PRIME2;
+        hash ^= hash >> 29;
+        hash *= PRIME3;
+        return hash ^ (hash >> 32);
+      }
+    
+    private:
+      
+      static inline uint64_t rotate(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+      }
+      
+      inline void round(const unsigned char *bytes) {
+        for (int lane = 0; lane < 4; ++lane) {
+          uint64_t word;
+          memcpy(&word, bytes + lane * 8, 8);
+          this->lanes[lane] = rotate(this->lanes[lane] + word * PRIME2, 31) * PRIME1;
+        }
+      }
+    };
+    
+    /**
+     * returns the header for count items of itemSize bytes
+     */
+    inline Header header(size_t itemSize, uint64_t count, uint64_t checksum) {
+      Header header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, "FNDVECB", 8);
+      header.version = VERSION;
+      header.byteOrder = BYTE_ORDER_MARK;
+      header.itemSize = (uint32_t)itemSize;
+      header.count = count;
+      header.checksum = checksum;
+      return header;
+    }
+    
+    /**
+     * writes all buffers to the file descriptor, partial writes are
+     * continued
+     * @throws SerializationException if the write fails
+     */
+    inline void writeAll(int fd, struct iovec *buffers, int count) {
+      while (count > 0) {
+        ssize_t written = writev(fd, buffers, count);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          throw SerializationException("can't be written", errno);
+        }
+        
+        // skip the buffers that were written completely
+        while (count > 0 && (size_t)written >= buffers->iov_len) {
+          written -= buffers->iov_len;
+          buffers++;
+          count--;
+        }
+        if (count > 0) {
+          buffers->iov_base = (char *)buffers->iov_base + written;
+          buffers->iov_len -= written;
+        }
+      }
+    }
+    
+    /**
+     * reads size bytes from the file descriptor, partial reads are
+     * continued
+     * @return the number of bytes read, which is only less than size at
+     *         the end of the file
+     * @throws SerializationException if the read fails
+     */
+    inline size_t readAll(int fd, void *buffer, size_t size) {
+      size_t done = 0;
+      while (done < size) {
+        ssize_t bytes = read(fd, (char *)buffer + done, size - done);
+        if (bytes < 0) {
+          if (errno == EINTR) continue;
+          throw SerializationException("can't be read", errno);
+        }
+        if (bytes == 0) break;
+        done += bytes;
+      }
+      return done;
+    }
+    
+    /**
+     * reads and verifies the header of a vector with items of itemSize
+     * bytes
+     * @throws SerializationException if the header is missing or invalid
+     */
+    inline Header readHeader(int fd, size_t itemSize) {
+      Header header;
+      if (readAll(fd, &header, sizeof(header)) != sizeof(header) ||
+          memcmp(header.magic, "FNDVECB", 8) != 0) {
+        throw SerializationException("has no valid header");
+      }
+      if (header.version != VERSION) {
+        throw SerializationException("has an unknown version");
+      }
+      if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw SerializationException("was written with another byte order");
+      }
+      if (header.itemSize != itemSize) {
+        throw SerializationException("was written with items of another size");
+      }
+      return header;
+    }
+  };
+  
+  /**
+   * reads a written vector in chunks of a fixed number of items, so that
+   * files of any size can be read with bounded memory:
+   *
+   *   VectorReader<int> reader(fd);
+   *   VectorView<int> chunk;
+   *   while (reader.next(chunk)) process(chunk);
+   *
+   * The checksum is verified when the last chunk was read, so the items of
+   * a damaged file are only detected at the end.
+   */
+  template <typename Item, typename Index = int>
+  class VectorReader {
+    static_assert(std::is_trivially_copyable<Item>::value,
+                  "only trivially copyable items can be read");
+  
+  private:
+    
+    int fd;
+    Serialization::Header header;
+    Serialization::Checksum checksum;
+    
+    /// the number of items that were read so far
+    uint64_t done;
+    
+    /// the buffer for one chunk
+    Item *buffer;
+    Index chunkSize;
+    
+    VectorReader(const VectorReader<Item, Index> &other);
+    VectorReader<Item, Index> &operator=(const VectorReader<Item, Index> &other);
+  
+  public:
+    
+    /**
+     * reads the header of the vector
+     * @param fd the file descriptor to read from
+     * @param chunkSize the max number of items in a chunk, by default as
+     *                  many as fit into 64 KB
+     * @throws SerializationException if the header is invalid
+     * @throws std::bad_alloc if the buffer can't be allocated
+     */
+    VectorReader(int fd, Index chunkSize = 0)
+    :fd(fd), header(Serialization::readHeader(fd, sizeof(Item))), done(0),
+     buffer(NULL), chunkSize(chunkSize)
+    {
+      if (this->chunkSize <= 0) {
+        this->chunkSize = (Index)std::max<size_t>(1, Serialization::CHUNK_BYTES / sizeof(Item));
+      }
+      this->buffer = (Item *)malloc(this->chunkSize * sizeof(Item));
+      if (this->buffer == NULL) throw std::bad_alloc();
+    }
+    
+    ~VectorReader() {
+      free(this->buffer);
+    }
+    
+    /**
+     * returns the number of items of the vector
+     */
+    uint64_t size() const {
+      return this->header.count;
+    }
+    
+    /**
+     * reads the next chunk
+     * @param chunk the view that is set to the items of the chunk. It is
+     *              valid until the next call or the reader is destroyed.
+     * @return false if all items were read
+     * @throws SerializationException if the file ends too early or the
+     *                                checksum doesn't match
+     */
+    bool next(VectorView<Item, Index> &chunk) {
+      uint64_t remaining = this->header.count - this->done;
+      if (remaining == 0) {
+        chunk = VectorView<Item, Index>(this->buffer, 0);
+        return false;
+      }
+      
+      Index count = (Index)std::min<uint64_t>(remaining, this->chunkSize);
+      size_t bytes = count * sizeof(Item);
+      if (Serialization::readAll(this->fd, this->buffer, bytes) != bytes) {
+        throw SerializationException("ends before the last item");
+      }
+      this->checksum.update(this->buffer, bytes);
+      this->done += count;
+      if (this->done == this->header.count &&
+          this->checksum.value() != this->header.checksum) {
+        throw SerializationException("has a wrong checksum");
+      }
+      
+      chunk = VectorView<Item, Index>(this->buffer, count);
+      return true;
+    }
+  };
+};
+
+#endif
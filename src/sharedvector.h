@@ -0,0 +1,412 @@
+/*
+ *  sharedvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SHAREDVECTOR
+#define FOUNDATION_SHAREDVECTOR
+
+#include <atomic>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * a vector whose copies and slices share the items until they are
+   * changed (copy on write). Copying or slicing is O(1), the items are only
+   * copied by the first change of a copy or slice whose buffer is shared.
+   * The buffers are reference counted, the counts are thread safe, so
+   * copies can be passed to and used by other threads.
+   *
+   * Reading through a const vector, view() or pipe() never copies. All
+   * other methods that can change items (like the non const at()) make the
+   * items private first. References that are returned by them are only
+   * valid until the vector is copied.
+   */
+  template <typename Item, typename Index = int>
+  class SharedVector {
+  private:
+    
+    /// the items and the number of vectors that share them
+    struct Buffer {
+      std::atomic<long> references;
+      Vector<Item, Index> items;
+      
+      Buffer(Index size)
+      :references(1), items(size)
+      {}
+      
+      Buffer(const VectorView<Item, Index> &items)
+      :references(1), items(items.size() > 0 ? items.size() : 1)
+      {
+        this->items.append(items);
+      }
+    };
+    
+    /// the shared buffer
+    Buffer *buffer;
+    
+    /// the range of the buffer that belongs to the vector
+    Index offset;
+    Index elementsSize;
+  
+  public:
+    
+    /**
+     * initialize the vector with a new (private) buffer
+     * @param size the first initial max size for the vector
+     */
+    SharedVector(Index size = 10)
+    :buffer(new Buffer(size)), offset(0), elementsSize(0)
+    {}
+    
+    /**
+     * initialize the vector with a copy of the items, this is the only time
+     * the items are copied until they are changed.
+     * @param items the items to copy
+     */
+    SharedVector(const VectorView<Item, Index> &items)
+    :buffer(new Buffer(items)), offset(0), elementsSize(items.size())
+    {}
+    
+    template <typename Allocator, typename Bounds>
+    SharedVector(const Vector<Item, Index, Allocator, Bounds> &items)
+    :buffer(new Buffer(items.view())), offset(0), elementsSize(items.size())
+    {}
+    
+    /**
+     * initialize the vector as a copy of the other one, which shares the
+     * items of the other vector. O(1)
+     */
+    SharedVector(const SharedVector<Item, Index> &other)
+    :buffer(other.buffer), offset(other.offset), elementsSize(other.elementsSize)
+    {
+      this->buffer->references.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    SharedVector<Item, Index> &operator=(const SharedVector<Item, Index> &other) {
+      if (this->buffer != other.buffer) {
+        other.buffer->references.fetch_add(1, std::memory_order_relaxed);
+        this->release();
+        this->buffer = other.buffer;
+      }
+      this->offset = other.offset;
+      this->elementsSize = other.elementsSize;
+      return *this;
+    }
+    
+    /**
+     * releases the buffer, which is deleted by the last vector using it
+     */
+    ~SharedVector() {
+      this->release();
+    }
+    
+    /**
+     * returns the size of the vector
+     */
+    Index size() const {
+      return this->elementsSize;
+    }
+    
+    /**
+     * returns true if the vector is empty
+     */
+    bool isEmpty() const {
+      return this->elementsSize == 0;
+    }
+    
+    /**
+     * returns true if other vectors share the items of this vector
+     */
+    bool isShared() const {
+      return this->buffer->references.load(std::memory_order_acquire) > 1;
+    }
+    
+    /**
+     * returns a view on the items, which doesn't copy the items. The view
+     * is valid until the vector is changed or destroyed.
+     */
+    VectorView<Item, Index> view() const {
+      return VectorView<Item, Index>(this->buffer->items.view().begin() + this->offset,
+                                     this->elementsSize);
+    }
+    
+    /**
+     * returns a lazy pipe over the items, see Pipe
+     */
+    Pipe<PipeSource<Item>, Index> pipe() const {
+      return this->view().pipe();
+    }
+    
+    /**
+     * returns the item at the passed index without copying the items
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    const Item &at(const Index index) const {
+      return this->view().at(index);
+    }
+    
+    /**
+     * returns a reference to the item at the passed index, which makes the
+     * items private first
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    Item &at(const Index index) {
+      this->view().at(index);
+      return this->modify().at(index);
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->at(index);
+    }
+    
+    Item &operator[](const Index index) {
+      return this->at(index);
+    }
+    
+    /**
+     * returns the first item
+     * @throws VectorAccessException if the vector is empty
+     */
+    const Item &first() const {
+      return this->view().first();
+    }
+    
+    /**
+     * returns the last item
+     * @throws VectorAccessException if the vector is empty
+     */
+    const Item &last() const {
+      return this->view().last();
+    }
+    
+    /**
+     * returns the index of the first item equal to item or -1
+     */
+    Index index(const Item item) const {
+      return this->view().index(item);
+    }
+    
+    /**
+     * returns the index of the last item equal to item or -1
+     */
+    Index lastIndex(const Item item) const {
+      return this->view().lastIndex(item);
+    }
+    
+    /**
+     * returns true if the item is in the vector
+     */
+    bool contains(const Item item) const {
+      return this->view().contains(item);
+    }
+    
+    /**
+     * returns the number of items that are equal to item
+     */
+    Index count(const Item item) const {
+      return this->view().count(item);
+    }
+    
+    /**
+     * returns a copy that shares the items with this vector. O(1)
+     */
+    SharedVector<Item, Index> copy() const {
+      return *this;
+    }
+    
+    /**
+     * returns a slice from the start index to the end, that shares the
+     * items with this vector. O(1)
+     * @param start the start index, negative means Nth item before end
+     */
+    SharedVector<Item, Index> slice(const Index start) const {
+      return this->sliceOf(this->view().slice(start));
+    }
+    
+    /**
+     * returns a slice with size items from the start index, that shares
+     * the items with this vector. The same boundary checks as for
+     * Vector::slice apply. O(1)
+     * @param start the start index, negative means Nth item before end
+     * @param size the number of items in the slice
+     */
+    SharedVector<Item, Index> slice(const Index start, const Index size) const {
+      return this->sliceOf(this->view().slice(start, size));
+    }
+    
+    /**
+     * adds an item to the vector
+     * @return self (the current vector) to enable chaining of <<
+     */
+    SharedVector<Item, Index> &operator<<(const Item &item) {
+      this->modify() << item;
+      return this->synchronize();
+    }
+    
+    SharedVector<Item, Index> &operator<<(Item &&item) {
+      this->modify() << std::move(item);
+      return this->synchronize();
+    }
+    
+    /**
+     * adds all items of the view to the end of the vector
+     */
+    SharedVector<Item, Index> &append(const VectorView<Item, Index> &items) {
+      if (this->isShared() || this->offset != 0 ||
+          this->elementsSize != this->buffer->items.size()) {
+        // the items may belong to the buffer that is released
+        Buffer *copy = new Buffer(this->view());
+        copy->items.append(items);
+        this->release();
+        this->buffer = copy;
+        this->offset = 0;
+      } else {
+        this->buffer->items.append(items);
+      }
+      return this->synchronize();
+    }
+    
+    /**
+     * removes the item at the passed index
+     * @return the item that was removed
+     */
+    Item removeAt(const Index index) {
+      Item item = this->modify().removeAt(index);
+      this->synchronize();
+      return item;
+    }
+    
+    /**
+     * removes all items that are equal to item
+     * @return the count of deleted items
+     */
+    Index remove(const Item &item) {
+      if (!this->contains(item)) return 0;
+      Index removed = this->modify().remove(item);
+      this->synchronize();
+      return removed;
+    }
+    
+    /**
+     * removes all items for which the predicate returns true
+     * @return the count of deleted items
+     */
+    template <typename Predicate>
+    Index removeIf(Predicate predicate) {
+      Index removed = this->modify().removeIf(predicate);
+      this->synchronize();
+      return removed;
+    }
+    
+    /**
+     * sorts the items like Vector::sort
+     */
+    void sort() {
+      this->modify().sort();
+    }
+    
+    template <typename Compare>
+    void sort(Compare compare) {
+      this->modify().sort(compare);
+    }
+    
+    /**
+     * maps the items like Vector::map
+     */
+    template <typename Mapping>
+    void map(Mapping fn) {
+      this->modify().map(fn);
+    }
+    
+    /**
+     * reverses the items
+     */
+    void reverse() {
+      this->modify().reverse();
+    }
+    
+    /**
+     * removes all items, the buffer is only released if it is shared
+     */
+    void clear() {
+      if (this->isShared() || this->offset != 0) {
+        this->release();
+        this->buffer = new Buffer(10);
+        this->offset = 0;
+      } else {
+        this->buffer->items.clear();
+      }
+      this->synchronize();
+    }
+    
+    /**
+     * returns a string representation of the vector
+     */
+    std::string inspect() const {
+      std::string details;
+      Format::StringSink sink(details);
+      Format::details(sink, "Foundation::SharedVector", this, this->view().begin(),
+                      (size_t)this->size());
+      return details;
+    }
+    
+    /**
+     * returns a string representation of the values of the vector
+     */
+    std::string toString() const {
+      return this->view().toString();
+    }
+  
+  protected:
+    
+    /**
+     * returns the vector that holds the items, to change them. The items
+     * are copied first, if they are shared with other vectors or the vector
+     * is a slice. Changes of the size have to be followed by synchronize().
+     */
+    Vector<Item, Index> &modify() {
+      if (this->isShared() || this->offset != 0 ||
+          this->elementsSize != this->buffer->items.size()) {
+        Buffer *copy = new Buffer(this->view());
+        this->release();
+        this->buffer = copy;
+        this->offset = 0;
+      }
+      return this->buffer->items;
+    }
+    
+    /**
+     * returns a vector sharing the buffer for the range of the view
+     */
+    SharedVector<Item, Index> sliceOf(const VectorView<Item, Index> &range) const {
+      SharedVector<Item, Index> slice(*this);
+      slice.offset = (Index)(range.begin() - this->buffer->items.view().begin());
+      slice.elementsSize = range.size();
+      return slice;
+    }
+    
+    /**
+     * updates the size after the (private) items were changed
+     */
+    SharedVector<Item, Index> &synchronize() {
+      this->elementsSize = this->buffer->items.size();
+      return *this;
+    }
+    
+    /**
+     * gives up the share of the buffer, the last vector deletes it
+     */
+    void release() {
+      if (this->buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this->buffer;
+      }
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,939 @@
+/*
+ *  simd.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SIMD
+#define FOUNDATION_SIMD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define FOUNDATION_SIMD_X86
+#define FOUNDATION_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace Foundation {
+  namespace Simd {
+    /// the instruction sets the kernels can use
+    enum Level { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+    
+    /**
+     * returns the best instruction set the cpu supports
+     */
+    inline Level detectLevel() {
+#ifdef FOUNDATION_SIMD_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) return AVX2;
+      return SSE2;
+#else
+      return SCALAR;
+#endif
+    }
+    
+    /**
+     * returns a reference to the instruction set that is used by the kernels
+     */
+    inline Level &currentLevel() {
+      static Level level = detectLevel();
+      return level;
+    }
+    
+    /**
+     * returns the instruction set that is used by the kernels
+     */
+    inline Level level() {
+      return currentLevel();
+    }
+    
+    /**
+     * limits the instruction set that is used by the kernels, e.g. to test
+     * or compare the fallbacks. The level can't be raised above the one
+     * supported by the cpu.
+     * @param level the best instruction set to use
+     */
+    inline void setLevel(Level level) {
+      Level supported = detectLevel();
+      currentLevel() = level < supported ? level : supported;
+    }
+    
+    /**
+     * true for the item types that have vectorized kernels: integral types
+     * and float and double.
+     */
+    template <typename Item>
+    struct Supported {
+      static const bool value =
+        (std::is_integral<Item>::value && !std::is_same<Item, bool>::value &&
+         (sizeof(Item) == 1 || sizeof(Item) == 2 ||
+          sizeof(Item) == 4 || sizeof(Item) == 8)) ||
+        std::is_same<Item, float>::value || std::is_same<Item, double>::value;
+    };
+
+#ifdef FOUNDATION_SIMD_X86
+    /**
+     * the vector operations for one item type. splat fills a register with
+     * the item, equal sets all bits of the lanes that are equal to the item.
+     */
+    template <typename Item, size_t size = sizeof(Item),
+              bool floating = std::is_floating_point<Item>::value>
+    struct Lanes;
+    
+    template <typename Item>
+    struct Lanes<Item, 1, false> {
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi8((char)item);
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        __m128i data = _mm_loadu_si128((const __m128i *)items);
+        return _mm_cmpeq_epi8(data, value);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi8((char)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256i data = _mm256_loadu_si256((const __m256i *)items);
+        return _mm256_cmpeq_epi8(data, value);
+      }
+    };
+    
+    template <typename Item>
+    struct Lanes<Item, 2, false> {
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi16((short)item);
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        __m128i data = _mm_loadu_si128((const __m128i *)items);
+        return _mm_cmpeq_epi16(data, value);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi16((short)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256i data = _mm256_loadu_si256((const __m256i *)items);
+        return _mm256_cmpeq_epi16(data, value);
+      }
+    };
+    
+    template <typename Item>
+    struct Lanes<Item, 4, false> {
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi32((int)item);
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        __m128i data = _mm_loadu_si128((const __m128i *)items);
+        return _mm_cmpeq_epi32(data, value);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi32((int)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256i data = _mm256_loadu_si256((const __m256i *)items);
+        return _mm256_cmpeq_epi32(data, value);
+      }
+    };
+    
+    template <typename Item>
+    struct Lanes<Item, 8, false> {
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi64x((long long)item);
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        // SSE2 has no 64 bit compare, both 32 bit halves have to be equal
+        __m128i data = _mm_loadu_si128((const __m128i *)items);
+        __m128i halves = _mm_cmpeq_epi32(data, value);
+        __m128i swapped = _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_and_si128(halves, swapped);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi64x((long long)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256i data = _mm256_loadu_si256((const __m256i *)items);
+        return _mm256_cmpeq_epi64(data, value);
+      }
+    };
+    
+    template <typename Item>
+    struct Lanes<Item, 4, true> {
+      static inline __m128i splat128(Item item) {
+        return _mm_castps_si128(_mm_set1_ps(item));
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        __m128 data = _mm_loadu_ps(items);
+        __m128 equal = _mm_cmpeq_ps(data, _mm_castsi128_ps(value));
+        return _mm_castps_si128(equal);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_castps_si256(_mm256_set1_ps(item));
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256 data = _mm256_loadu_ps(items);
+        __m256 equal = _mm256_cmp_ps(data, _mm256_castsi256_ps(value), _CMP_EQ_OQ);
+        return _mm256_castps_si256(equal);
+      }
+    };
+    
+    template <typename Item>
+    struct Lanes<Item, 8, true> {
+      static inline __m128i splat128(Item item) {
+        return _mm_castpd_si128(_mm_set1_pd(item));
+      }
+      static inline __m128i equal128(const Item *items, __m128i value) {
+        __m128d data = _mm_loadu_pd(items);
+        __m128d equal = _mm_cmpeq_pd(data, _mm_castsi128_pd(value));
+        return _mm_castpd_si128(equal);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_castpd_si256(_mm256_set1_pd(item));
+      }
+      FOUNDATION_AVX2 static inline __m256i equal256(const Item *items, __m256i value) {
+        __m256d data = _mm256_loadu_pd(items);
+        __m256d equal = _mm256_cmp_pd(data, _mm256_castsi256_pd(value), _CMP_EQ_OQ);
+        return _mm256_castpd_si256(equal);
+      }
+    };
+    
+    /**
+     * the search kernels for one instruction set. find and findLast compare
+     * four registers per step, count sums the equal lanes in byte counters
+     * which are added up before they can overflow. The rest is handled by 
+     * the scalar loop.
+     */
+    template <typename Item>
+    struct Sse2Search {
+      static const size_t lanes = 16 / sizeof(Item);
+      
+      static inline uint64_t mask(const Item *items, __m128i value) {
+        __m128i a = Lanes<Item>::equal128(items, value);
+        __m128i b = Lanes<Item>::equal128(items + lanes, value);
+        __m128i c = Lanes<Item>::equal128(items + 2 * lanes, value);
+        __m128i d = Lanes<Item>::equal128(items + 3 * lanes, value);
+        return (uint64_t)(unsigned)_mm_movemask_epi8(a) |
+               ((uint64_t)(unsigned)_mm_movemask_epi8(b) << 16) |
+               ((uint64_t)(unsigned)_mm_movemask_epi8(c) << 32) |
+               ((uint64_t)(unsigned)_mm_movemask_epi8(d) << 48);
+      }
+      
+      static ptrdiff_t find(const Item *items, size_t size, Item item) {
+        __m128i value = Lanes<Item>::splat128(item);
+        size_t i = 0;
+        for (; i + 4 * lanes <= size; i += 4 * lanes) {
+          uint64_t found = mask(items + i, value);
+          if (found) return i + __builtin_ctzll(found) / sizeof(Item);
+        }
+        for (; i < size; ++i) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      static ptrdiff_t findLast(const Item *items, size_t size, Item item) {
+        __m128i value = Lanes<Item>::splat128(item);
+        size_t i = size;
+        for (; i >= 4 * lanes; i -= 4 * lanes) {
+          uint64_t found = mask(items + i - 4 * lanes, value);
+          if (found) {
+            return (i - 4 * lanes) + (63 - __builtin_clzll(found)) / sizeof(Item);
+          }
+        }
+        while (i-- > 0) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      static size_t count(const Item *items, size_t size, Item item) {
+        __m128i value = Lanes<Item>::splat128(item);
+        __m128i zero = _mm_setzero_si128();
+        __m128i total = zero;
+        size_t i = 0;
+        while (i + lanes <= size) {
+          // every equal lane adds one to sizeof(Item) byte counters
+          __m128i counters = zero;
+          for (int step = 0; step < 255 && i + lanes <= size; ++step, i += lanes) {
+            counters = _mm_sub_epi8(counters, Lanes<Item>::equal128(items + i, value));
+          }
+          total = _mm_add_epi64(total, _mm_sad_epu8(counters, zero));
+        }
+        uint64_t sums[2];
+        _mm_storeu_si128((__m128i *)sums, total);
+        size_t found = (size_t)((sums[0] + sums[1]) / sizeof(Item));
+        for (; i < size; ++i) {
+          if (items[i] == item) found++;
+        }
+        return found;
+      }
+    };
+    
+    template <typename Item>
+    struct Avx2Search {
+      static const size_t lanes = 32 / sizeof(Item);
+      
+      FOUNDATION_AVX2 static inline uint64_t mask(const Item *items, __m256i value) {
+        __m256i a = Lanes<Item>::equal256(items, value);
+        __m256i b = Lanes<Item>::equal256(items + lanes, value);
+        return (uint64_t)(unsigned)_mm256_movemask_epi8(a) |
+               ((uint64_t)(unsigned)_mm256_movemask_epi8(b) << 32);
+      }
+      
+      FOUNDATION_AVX2 static inline bool any(const Item *items, __m256i value) {
+        __m256i a = Lanes<Item>::equal256(items, value);
+        __m256i b = Lanes<Item>::equal256(items + lanes, value);
+        __m256i c = Lanes<Item>::equal256(items + 2 * lanes, value);
+        __m256i d = Lanes<Item>::equal256(items + 3 * lanes, value);
+        __m256i all = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        return !_mm256_testz_si256(all, all);
+      }
+      
+      FOUNDATION_AVX2 static ptrdiff_t find(const Item *items, size_t size, Item item) {
+        __m256i value = Lanes<Item>::splat256(item);
+        size_t i = 0;
+        for (; i + 4 * lanes <= size; i += 4 * lanes) {
+          if (any(items + i, value)) {
+            uint64_t found = mask(items + i, value);
+            if (found) return i + __builtin_ctzll(found) / sizeof(Item);
+            found = mask(items + i + 2 * lanes, value);
+            return i + 2 * lanes + __builtin_ctzll(found) / sizeof(Item);
+          }
+        }
+        for (; i < size; ++i) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      FOUNDATION_AVX2 static ptrdiff_t findLast(const Item *items, size_t size, Item item) {
+        __m256i value = Lanes<Item>::splat256(item);
+        size_t i = size;
+        for (; i >= 4 * lanes; i -= 4 * lanes) {
+          const Item *block = items + i - 4 * lanes;
+          if (any(block, value)) {
+            uint64_t found = mask(block + 2 * lanes, value);
+            if (found) {
+              return (i - 2 * lanes) + (63 - __builtin_clzll(found)) / sizeof(Item);
+            }
+            found = mask(block, value);
+            return (i - 4 * lanes) + (63 - __builtin_clzll(found)) / sizeof(Item);
+          }
+        }
+        while (i-- > 0) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      FOUNDATION_AVX2 static size_t count(const Item *items, size_t size, Item item) {
+        __m256i value = Lanes<Item>::splat256(item);
+        __m256i zero = _mm256_setzero_si256();
+        __m256i total = zero;
+        size_t i = 0;
+        while (i + lanes <= size) {
+          __m256i counters = zero;
+          for (int step = 0; step < 255 && i + lanes <= size; ++step, i += lanes) {
+            counters = _mm256_sub_epi8(counters, Lanes<Item>::equal256(items + i, value));
+          }
+          total = _mm256_add_epi64(total, _mm256_sad_epu8(counters, zero));
+        }
+        uint64_t sums[4];
+        _mm256_storeu_si256((__m256i *)sums, total);
+        size_t found = (size_t)((sums[0] + sums[1] + sums[2] + sums[3]) / sizeof(Item));
+        for (; i < size; ++i) {
+          if (items[i] == item) found++;
+        }
+        return found;
+      }
+    };
+#endif
+    
+    /**
+     * the scalar search kernels, used for all other item types and if the
+     * cpu has no supported instruction set
+     */
+    template <typename Item>
+    struct ScalarSearch {
+      static ptrdiff_t find(const Item *items, size_t size, const Item &item) {
+        for (size_t i = 0; i < size; ++i) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      static ptrdiff_t findLast(const Item *items, size_t size, const Item &item) {
+        for (size_t i = size; i-- > 0;) {
+          if (items[i] == item) return i;
+        }
+        return -1;
+      }
+      
+      static size_t count(const Item *items, size_t size, const Item &item) {
+        size_t found = 0;
+        for (size_t i = 0; i < size; ++i) {
+          if (items[i] == item) found++;
+        }
+        return found;
+      }
+    };
+    
+    template <typename Item, bool supported = Supported<Item>::value>
+    struct Search : public ScalarSearch<Item> {};
+
+#ifdef FOUNDATION_SIMD_X86
+    template <typename Item>
+    struct Search<Item, true> {
+      static ptrdiff_t find(const Item *items, size_t size, Item item) {
+        switch (level()) {
+          case AVX2: return Avx2Search<Item>::find(items, size, item);
+          case SSE2: return Sse2Search<Item>::find(items, size, item);
+          default: return ScalarSearch<Item>::find(items, size, item);
+        }
+      }
+      
+      static ptrdiff_t findLast(const Item *items, size_t size, Item item) {
+        switch (level()) {
+          case AVX2: return Avx2Search<Item>::findLast(items, size, item);
+          case SSE2: return Sse2Search<Item>::findLast(items, size, item);
+          default: return ScalarSearch<Item>::findLast(items, size, item);
+        }
+      }
+      
+      static size_t count(const Item *items, size_t size, Item item) {
+        switch (level()) {
+          case AVX2: return Avx2Search<Item>::count(items, size, item);
+          case SSE2: return Sse2Search<Item>::count(items, size, item);
+          default: return ScalarSearch<Item>::count(items, size, item);
+        }
+      }
+    };
+#endif
+    
+    /**
+     * the type the searched item is passed as. Numbers are passed by value,
+     * so that they don't have to be kept in memory for the kernels.
+     */
+    template <typename Item>
+    struct Needle {
+      typedef typename std::conditional<std::is_arithmetic<Item>::value, 
+                                        Item, const Item &>::type Type;
+    };
+    
+    /**
+     * returns the position of the first item that is equal to the passed one
+     * or -1 if there is none
+     */
+    template <typename Item>
+    inline ptrdiff_t find(const Item *items, size_t size, typename Needle<Item>::Type item) {
+      if (size == 0) return -1;
+      return Search<Item>::find(items, size, item);
+    }
+    
+    /**
+     * returns the position of the last item that is equal to the passed one
+     * or -1 if there is none. The items are searched from the end.
+     */
+    template <typename Item>
+    inline ptrdiff_t findLast(const Item *items, size_t size,
+                              typename Needle<Item>::Type item) {
+      if (size == 0) return -1;
+      return Search<Item>::findLast(items, size, item);
+    }
+    
+    /**
+     * returns the number of items that are equal to the passed one
+     */
+    template <typename Item>
+    inline size_t count(const Item *items, size_t size, typename Needle<Item>::Type item) {
+      if (size == 0) return 0;
+      return Search<Item>::count(items, size, item);
+    }
+    
+    /**
+     * the type the items are summed up in: 64 bit integers for integral
+     * items, double for floating point items and the item type for all
+     * other types
+     */
+    template <typename Item, typename Enable = void>
+    struct SumOf {
+      typedef Item Type;
+    };
+    
+    template <typename Item>
+    struct SumOf<Item, typename std::enable_if<std::is_integral<Item>::value>::type> {
+      typedef typename std::conditional<std::is_signed<Item>::value, 
+                                        int64_t, uint64_t>::type Type;
+    };
+    
+    template <typename Item>
+    struct SumOf<Item, typename std::enable_if<std::is_floating_point<Item>::value>::type> {
+      typedef double Type;
+    };
+    
+    /**
+     * true for the item types that have vectorized aggregate kernels: 32 bit
+     * integers, float and double
+     */
+    template <typename Item>
+    struct AggregateSupported {
+      static const bool value =
+        (std::is_integral<Item>::value && !std::is_same<Item, bool>::value &&
+         sizeof(Item) == 4) ||
+        std::is_same<Item, float>::value || std::is_same<Item, double>::value;
+    };
+
+#ifdef FOUNDATION_SIMD_X86
+    /**
+     * the arithmetic operations of one item type for the aggregate kernels.
+     * min and max return the item if it is smaller (or bigger) than best and
+     * best otherwise, like the scalar loop does, so NaNs are skipped. add 
+     * adds the lanes to a total with wider lanes (64 bit integers or double).
+     */
+    template <typename Item, size_t size = sizeof(Item),
+              bool floating = std::is_floating_point<Item>::value,
+              bool sign = std::is_signed<Item>::value>
+    struct Arithmetic;
+    
+    template <typename Item>
+    struct Arithmetic<Item, 4, false, true> {
+      typedef __m128i Data128;
+      typedef __m128i Total128;
+      typedef __m256i Data256;
+      typedef __m256i Total256;
+      
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi32((int)item);
+      }
+      static inline __m128i load128(const Item *items) {
+        return _mm_loadu_si128((const __m128i *)items);
+      }
+      static inline __m128i min128(__m128i item, __m128i best) {
+        __m128i smaller = _mm_cmplt_epi32(item, best);
+        return _mm_or_si128(_mm_and_si128(smaller, item), _mm_andnot_si128(smaller, best));
+      }
+      static inline __m128i max128(__m128i item, __m128i best) {
+        __m128i bigger = _mm_cmpgt_epi32(item, best);
+        return _mm_or_si128(_mm_and_si128(bigger, item), _mm_andnot_si128(bigger, best));
+      }
+      static inline __m128i add128(__m128i total, __m128i data) {
+        __m128i sign = _mm_srai_epi32(data, 31);
+        total = _mm_add_epi64(total, _mm_unpacklo_epi32(data, sign));
+        return _mm_add_epi64(total, _mm_unpackhi_epi32(data, sign));
+      }
+      static inline __m128i merge128(__m128i left, __m128i right) {
+        return _mm_add_epi64(left, right);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi32((int)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i load256(const Item *items) {
+        return _mm256_loadu_si256((const __m256i *)items);
+      }
+      FOUNDATION_AVX2 static inline __m256i min256(__m256i item, __m256i best) {
+        return _mm256_min_epi32(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256i max256(__m256i item, __m256i best) {
+        return _mm256_max_epi32(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256i add256(__m256i total, __m256i data) {
+        total = _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(data)));
+        return _mm256_add_epi64(total, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(data, 1)));
+      }
+      FOUNDATION_AVX2 static inline __m256i merge256(__m256i left, __m256i right) {
+        return _mm256_add_epi64(left, right);
+      }
+    };
+    
+    template <typename Item>
+    struct Arithmetic<Item, 4, false, false> {
+      typedef __m128i Data128;
+      typedef __m128i Total128;
+      typedef __m256i Data256;
+      typedef __m256i Total256;
+      
+      static inline __m128i splat128(Item item) {
+        return _mm_set1_epi32((int)item);
+      }
+      static inline __m128i load128(const Item *items) {
+        return _mm_loadu_si128((const __m128i *)items);
+      }
+      static inline __m128i min128(__m128i item, __m128i best) {
+        // SSE2 only compares signed, flipping the sign bit keeps the order
+        __m128i flip = _mm_set1_epi32((int)0x80000000);
+        __m128i smaller = _mm_cmplt_epi32(_mm_xor_si128(item, flip), _mm_xor_si128(best, flip));
+        return _mm_or_si128(_mm_and_si128(smaller, item), _mm_andnot_si128(smaller, best));
+      }
+      static inline __m128i max128(__m128i item, __m128i best) {
+        __m128i flip = _mm_set1_epi32((int)0x80000000);
+        __m128i bigger = _mm_cmpgt_epi32(_mm_xor_si128(item, flip), _mm_xor_si128(best, flip));
+        return _mm_or_si128(_mm_and_si128(bigger, item), _mm_andnot_si128(bigger, best));
+      }
+      static inline __m128i add128(__m128i total, __m128i data) {
+        __m128i zero = _mm_setzero_si128();
+        total = _mm_add_epi64(total, _mm_unpacklo_epi32(data, zero));
+        return _mm_add_epi64(total, _mm_unpackhi_epi32(data, zero));
+      }
+      static inline __m128i merge128(__m128i left, __m128i right) {
+        return _mm_add_epi64(left, right);
+      }
+      FOUNDATION_AVX2 static inline __m256i splat256(Item item) {
+        return _mm256_set1_epi32((int)item);
+      }
+      FOUNDATION_AVX2 static inline __m256i load256(const Item *items) {
+        return _mm256_loadu_si256((const __m256i *)items);
+      }
+      FOUNDATION_AVX2 static inline __m256i min256(__m256i item, __m256i best) {
+        return _mm256_min_epu32(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256i max256(__m256i item, __m256i best) {
+        return _mm256_max_epu32(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256i add256(__m256i total, __m256i data) {
+        total = _mm256_add_epi64(total, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(data)));
+        return _mm256_add_epi64(total, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(data, 1)));
+      }
+      FOUNDATION_AVX2 static inline __m256i merge256(__m256i left, __m256i right) {
+        return _mm256_add_epi64(left, right);
+      }
+    };
+    
+    template <typename Item>
+    struct Arithmetic<Item, 4, true, true> {
+      typedef __m128 Data128;
+      typedef __m128d Total128;
+      typedef __m256 Data256;
+      typedef __m256d Total256;
+      
+      static inline __m128 splat128(Item item) {
+        return _mm_set1_ps(item);
+      }
+      static inline __m128 load128(const Item *items) {
+        return _mm_loadu_ps(items);
+      }
+      static inline __m128 min128(__m128 item, __m128 best) {
+        return _mm_min_ps(item, best);
+      }
+      static inline __m128 max128(__m128 item, __m128 best) {
+        return _mm_max_ps(item, best);
+      }
+      static inline __m128d add128(__m128d total, __m128 data) {
+        total = _mm_add_pd(total, _mm_cvtps_pd(data));
+        return _mm_add_pd(total, _mm_cvtps_pd(_mm_movehl_ps(data, data)));
+      }
+      static inline __m128d merge128(__m128d left, __m128d right) {
+        return _mm_add_pd(left, right);
+      }
+      FOUNDATION_AVX2 static inline __m256 splat256(Item item) {
+        return _mm256_set1_ps(item);
+      }
+      FOUNDATION_AVX2 static inline __m256 load256(const Item *items) {
+        return _mm256_loadu_ps(items);
+      }
+      FOUNDATION_AVX2 static inline __m256 min256(__m256 item, __m256 best) {
+        return _mm256_min_ps(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256 max256(__m256 item, __m256 best) {
+        return _mm256_max_ps(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256d add256(__m256d total, __m256 data) {
+        total = _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_castps256_ps128(data)));
+        return _mm256_add_pd(total, _mm256_cvtps_pd(_mm256_extractf128_ps(data, 1)));
+      }
+      FOUNDATION_AVX2 static inline __m256d merge256(__m256d left, __m256d right) {
+        return _mm256_add_pd(left, right);
+      }
+    };
+    
+    template <typename Item>
+    struct Arithmetic<Item, 8, true, true> {
+      typedef __m128d Data128;
+      typedef __m128d Total128;
+      typedef __m256d Data256;
+      typedef __m256d Total256;
+      
+      static inline __m128d splat128(Item item) {
+        return _mm_set1_pd(item);
+      }
+      static inline __m128d load128(const Item *items) {
+        return _mm_loadu_pd(items);
+      }
+      static inline __m128d min128(__m128d item, __m128d best) {
+        return _mm_min_pd(item, best);
+      }
+      static inline __m128d max128(__m128d item, __m128d best) {
+        return _mm_max_pd(item, best);
+      }
+      static inline __m128d add128(__m128d total, __m128d data) {
+        return _mm_add_pd(total, data);
+      }
+      static inline __m128d merge128(__m128d left, __m128d right) {
+        return _mm_add_pd(left, right);
+      }
+      FOUNDATION_AVX2 static inline __m256d splat256(Item item) {
+        return _mm256_set1_pd(item);
+      }
+      FOUNDATION_AVX2 static inline __m256d load256(const Item *items) {
+        return _mm256_loadu_pd(items);
+      }
+      FOUNDATION_AVX2 static inline __m256d min256(__m256d item, __m256d best) {
+        return _mm256_min_pd(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256d max256(__m256d item, __m256d best) {
+        return _mm256_max_pd(item, best);
+      }
+      FOUNDATION_AVX2 static inline __m256d add256(__m256d total, __m256d data) {
+        return _mm256_add_pd(total, data);
+      }
+      FOUNDATION_AVX2 static inline __m256d merge256(__m256d left, __m256d right) {
+        return _mm256_add_pd(left, right);
+      }
+    };
+    
+    /**
+     * the aggregate kernels for one instruction set. The sum adds four 
+     * registers per step into separate totals, extremes keeps two registers
+     * for the min and max. The lanes are combined by the scalar loop, which
+     * also handles the rest.
+     */
+    template <typename Item>
+    struct Sse2Aggregate {
+      typedef Arithmetic<Item> Ops;
+      typedef typename SumOf<Item>::Type Sum;
+      static const size_t lanes = 16 / sizeof(Item);
+      
+      static Sum sum(const Item *items, size_t size) {
+        typename Ops::Total128 a, b, c, d;
+        memset(&a, 0, sizeof(a));
+        b = c = d = a;
+        size_t i = 0;
+        for (; i + 4 * lanes <= size; i += 4 * lanes) {
+          a = Ops::add128(a, Ops::load128(items + i));
+          b = Ops::add128(b, Ops::load128(items + i + lanes));
+          c = Ops::add128(c, Ops::load128(items + i + 2 * lanes));
+          d = Ops::add128(d, Ops::load128(items + i + 3 * lanes));
+        }
+        typename Ops::Total128 total = Ops::merge128(Ops::merge128(a, b), Ops::merge128(c, d));
+        Sum sums[sizeof(total) / sizeof(Sum)];
+        memcpy(sums, &total, sizeof(total));
+        Sum found = sums[0] + sums[1];
+        for (; i < size; ++i) found += items[i];
+        return found;
+      }
+      
+      template <bool findMin, bool findMax>
+      static void extremes(const Item *items, size_t size, Item &min, Item &max) {
+        size_t i = 0;
+        if (size >= 2 * lanes) {
+          // all lanes start with the first item, which decides like in the
+          // scalar loop if there are NaNs
+          typename Ops::Data128 minA = Ops::splat128(items[0]), minB = minA;
+          typename Ops::Data128 maxA = minA, maxB = minA;
+          for (; i + 2 * lanes <= size; i += 2 * lanes) {
+            typename Ops::Data128 a = Ops::load128(items + i);
+            typename Ops::Data128 b = Ops::load128(items + i + lanes);
+            if (findMin) {
+              minA = Ops::min128(a, minA);
+              minB = Ops::min128(b, minB);
+            }
+            if (findMax) {
+              maxA = Ops::max128(a, maxA);
+              maxB = Ops::max128(b, maxB);
+            }
+          }
+          Item lanesMin[2 * lanes], lanesMax[2 * lanes];
+          memcpy(lanesMin, &minA, sizeof(minA));
+          memcpy(lanesMin + lanes, &minB, sizeof(minB));
+          memcpy(lanesMax, &maxA, sizeof(maxA));
+          memcpy(lanesMax + lanes, &maxB, sizeof(maxB));
+          combine<findMin, findMax>(lanesMin, lanesMax, 2 * lanes, min, max);
+        } else {
+          min = max = items[0];
+        }
+        for (; i < size; ++i) {
+          if (findMin && items[i] < min) min = items[i];
+          if (findMax && max < items[i]) max = items[i];
+        }
+      }
+      
+      /**
+       * combines the lanes of the registers in order, so the first item
+       * decides like in the scalar loop
+       */
+      template <bool findMin, bool findMax>
+      static inline void combine(const Item *lanesMin, const Item *lanesMax, size_t size,
+                                 Item &min, Item &max) {
+        min = lanesMin[0];
+        max = lanesMax[0];
+        for (size_t i = 1; i < size; ++i) {
+          if (findMin && lanesMin[i] < min) min = lanesMin[i];
+          if (findMax && max < lanesMax[i]) max = lanesMax[i];
+        }
+      }
+    };
+    
+    template <typename Item>
+    struct Avx2Aggregate {
+      typedef Arithmetic<Item> Ops;
+      typedef typename SumOf<Item>::Type Sum;
+      static const size_t lanes = 32 / sizeof(Item);
+      
+      FOUNDATION_AVX2 static Sum sum(const Item *items, size_t size) {
+        typename Ops::Total256 a, b, c, d;
+        memset(&a, 0, sizeof(a));
+        b = c = d = a;
+        size_t i = 0;
+        for (; i + 4 * lanes <= size; i += 4 * lanes) {
+          a = Ops::add256(a, Ops::load256(items + i));
+          b = Ops::add256(b, Ops::load256(items + i + lanes));
+          c = Ops::add256(c, Ops::load256(items + i + 2 * lanes));
+          d = Ops::add256(d, Ops::load256(items + i + 3 * lanes));
+        }
+        typename Ops::Total256 total = Ops::merge256(Ops::merge256(a, b), Ops::merge256(c, d));
+        Sum sums[sizeof(total) / sizeof(Sum)];
+        memcpy(sums, &total, sizeof(total));
+        Sum found = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        for (; i < size; ++i) found += items[i];
+        return found;
+      }
+      
+      template <bool findMin, bool findMax>
+      FOUNDATION_AVX2 static void extremes(const Item *items, size_t size, Item &min, Item &max) {
+        size_t i = 0;
+        if (size >= 2 * lanes) {
+          // all lanes start with the first item, which decides like in the
+          // scalar loop if there are NaNs
+          typename Ops::Data256 minA = Ops::splat256(items[0]), minB = minA;
+          typename Ops::Data256 maxA = minA, maxB = minA;
+          for (; i + 2 * lanes <= size; i += 2 * lanes) {
+            typename Ops::Data256 a = Ops::load256(items + i);
+            typename Ops::Data256 b = Ops::load256(items + i + lanes);
+            if (findMin) {
+              minA = Ops::min256(a, minA);
+              minB = Ops::min256(b, minB);
+            }
+            if (findMax) {
+              maxA = Ops::max256(a, maxA);
+              maxB = Ops::max256(b, maxB);
+            }
+          }
+          Item lanesMin[2 * lanes], lanesMax[2 * lanes];
+          memcpy(lanesMin, &minA, sizeof(minA));
+          memcpy(lanesMin + lanes, &minB, sizeof(minB));
+          memcpy(lanesMax, &maxA, sizeof(maxA));
+          memcpy(lanesMax + lanes, &maxB, sizeof(maxB));
+          Sse2Aggregate<Item>::template combine<findMin, findMax>(lanesMin, lanesMax, 
+                                                                  2 * lanes, min, max);
+        } else {
+          min = max = items[0];
+        }
+        for (; i < size; ++i) {
+          if (findMin && items[i] < min) min = items[i];
+          if (findMax && max < items[i]) max = items[i];
+        }
+      }
+    };
+#endif
+    
+    /**
+     * the scalar aggregate kernels, used for all other item types and if
+     * the cpu has no supported instruction set
+     */
+    template <typename Item>
+    struct ScalarAggregate {
+      typedef typename SumOf<Item>::Type Sum;
+      
+      static Sum sum(const Item *items, size_t size) {
+        Sum found = Sum();
+        for (size_t i = 0; i < size; ++i) found += items[i];
+        return found;
+      }
+      
+      template <bool findMin, bool findMax>
+      static void extremes(const Item *items, size_t size, Item &min, Item &max) {
+        min = max = items[0];
+        for (size_t i = 1; i < size; ++i) {
+          if (findMin && items[i] < min) min = items[i];
+          if (findMax && max < items[i]) max = items[i];
+        }
+      }
+    };
+    
+    template <typename Item, bool supported = AggregateSupported<Item>::value>
+    struct Aggregate : public ScalarAggregate<Item> {};
+
+#ifdef FOUNDATION_SIMD_X86
+    template <typename Item>
+    struct Aggregate<Item, true> {
+      typedef typename SumOf<Item>::Type Sum;
+      
+      static Sum sum(const Item *items, size_t size) {
+        switch (level()) {
+          case AVX2: return Avx2Aggregate<Item>::sum(items, size);
+          case SSE2: return Sse2Aggregate<Item>::sum(items, size);
+          default: return ScalarAggregate<Item>::sum(items, size);
+        }
+      }
+      
+      template <bool findMin, bool findMax>
+      static void extremes(const Item *items, size_t size, Item &min, Item &max) {
+        switch (level()) {
+          case AVX2:
+            Avx2Aggregate<Item>::template extremes<findMin, findMax>(items, size, min, max);
+            break;
+          case SSE2:
+            Sse2Aggregate<Item>::template extremes<findMin, findMax>(items, size, min, max);
+            break;
+          default:
+            ScalarAggregate<Item>::template extremes<findMin, findMax>(items, size, min, max);
+        }
+      }
+    };
+#endif
+    
+    /**
+     * returns the sum of the items, see SumOf for the type of the sum. The
+     * order of the additions of floating point items depends on the kernel.
+     */
+    template <typename Item>
+    inline typename SumOf<Item>::Type sum(const Item *items, size_t size) {
+      return Aggregate<Item>::sum(items, size);
+    }
+    
+    /**
+     * finds the smallest and biggest item. Like a loop using < the first 
+     * of equal items wins and NaNs are skipped, unless the first item is
+     * NaN. There has to be at least one item.
+     */
+    template <typename Item>
+    inline void minmax(const Item *items, size_t size, Item &min, Item &max) {
+      Aggregate<Item>::template extremes<true, true>(items, size, min, max);
+    }
+    
+    /**
+     * returns the smallest item, there has to be at least one item
+     */
+    template <typename Item>
+    inline Item min(const Item *items, size_t size) {
+      Item min, max;
+      Aggregate<Item>::template extremes<true, false>(items, size, min, max);
+      return min;
+    }
+    
+    /**
+     * returns the biggest item, there has to be at least one item
+     */
+    template <typename Item>
+    inline Item max(const Item *items, size_t size) {
+      Item min, max;
+      Aggregate<Item>::template extremes<false, true>(items, size, min, max);
+      return max;
+    }
+  };
+};
+
+#endif
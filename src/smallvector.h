@@ -0,0 +1,136 @@
+/*
+ *  smallvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SMALLVECTOR
+#define FOUNDATION_SMALLVECTOR
+
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * an allocator with space for N items inside of the allocator itself. The
+   * first allocation that fits is served from the inline space, everything
+   * else uses malloc. Because the vector stores its allocator, the items of
+   * small vectors live inside of the vector object. Copies of the allocator
+   * get their own (unused) inline space.
+   */
+  template <typename Item, int N>
+  class InlineAllocator {
+    static_assert(N > 0, "the inline space needs at least one item");
+  
+  private:
+    
+    /// the inline space for the items
+    alignas(Item) unsigned char storage[sizeof(Item) * N];
+    
+    /// true if the inline space is handed out
+    bool inUse;
+  
+  public:
+    
+    InlineAllocator()
+    :inUse(false)
+    {}
+    
+    InlineAllocator(const InlineAllocator<Item, N> &)
+    :inUse(false)
+    {}
+    
+    InlineAllocator<Item, N> &operator=(const InlineAllocator<Item, N> &) {
+      return *this;
+    }
+    
+    void *allocate(size_t bytes) {
+      if (!this->inUse && bytes <= sizeof(this->storage)) {
+        this->inUse = true;
+        return this->storage;
+      }
+      return malloc(bytes);
+    }
+    
+    void *reallocate(void *pointer, size_t oldBytes, size_t newBytes) {
+      if (pointer == NULL) return this->allocate(newBytes);
+      if (!this->isInline(pointer)) return realloc(pointer, newBytes);
+      if (newBytes <= sizeof(this->storage)) return pointer;
+      
+      // spill the items to the heap
+      void *moved = malloc(newBytes);
+      if (moved != NULL) {
+        memcpy(moved, pointer, oldBytes);
+        this->inUse = false;
+      }
+      return moved;
+    }
+    
+    void deallocate(void *pointer, size_t) {
+      if (this->isInline(pointer)) {
+        this->inUse = false;
+      } else {
+        free(pointer);
+      }
+    }
+    
+    /**
+     * returns true if the pointer points to the inline space
+     */
+    bool isInline(const void *pointer) const {
+      return pointer == (const void *)this->storage;
+    }
+  };
+  
+  /**
+   * the inline space can't be handed to another vector, so moved small
+   * vectors move their items one by one
+   */
+  template <typename Item, int N>
+  struct AllocatorTraits<InlineAllocator<Item, N> > {
+    static const bool transferable = false;
+  };
+  
+  /**
+   * a vector that keeps up to N items inline, in the object itself. Small
+   * vectors therefore need no heap allocation, the items are only moved to
+   * the heap once the vector grows bigger than N. The api is the same as
+   * the one of Vector.
+   */
+  template <typename Item, int N, typename Index = int>
+  class SmallVector : public Vector<Item, Index, InlineAllocator<Item, N> > {
+  public:
+    
+    typedef Vector<Item, Index, InlineAllocator<Item, N> > Base;
+    
+    /**
+     * initialize the vector with N items of inline space
+     */
+    SmallVector()
+    :Base(N)
+    {}
+    
+    /**
+     * initialize the vector with a copy of the passed array. Arrays up to N
+     * items are stored inline.
+     * @param array the array to copy in
+     * @param size the size of the passed array
+     */
+    SmallVector(Item * array, int size)
+    :Base(array, size)
+    {}
+    
+    SmallVector(const Base &other)
+    :Base(other)
+    {}
+    
+    /**
+     * returns true if the items are stored inline
+     */
+    bool isInline() const {
+      return this->allocator.isInline(this->elements);
+    }
+  };
+};
+
+#endif
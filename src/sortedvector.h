@@ -0,0 +1,453 @@
+/*
+ *  sortedvector.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_SORTEDVECTOR
+#define FOUNDATION_SORTEDVECTOR
+
+#include <algorithm>
+#include <functional>
+#include <stdint.h>
+#include <utility>
+#include "vector.h"
+
+namespace Foundation {
+  /**
+   * searches the sorted items using std::lower_bound and std::upper_bound
+   */
+  template <typename Item, typename Index = int>
+  class BinarySearch {
+  public:
+    
+    void invalidate() {}
+    
+    template <typename Less>
+    Index lowerBound(const Item *items, Index size, const Item &item, Less &less) {
+      return (Index)(std::lower_bound(items, items + size, item, less) - items);
+    }
+    
+    template <typename Less>
+    Index upperBound(const Item *items, Index size, const Item &item, Less &less) {
+      return (Index)(std::upper_bound(items, items + size, item, less) - items);
+    }
+  };
+  
+  /**
+   * searches the sorted items by halving the range without a branch, the
+   * comparison only selects the next start (a conditional move). The loop
+   * runs log2(N) times for every search, but there are no mispredictions.
+   */
+  template <typename Item, typename Index = int>
+  class BranchlessSearch {
+  public:
+    
+    void invalidate() {}
+    
+    template <typename Less>
+    Index lowerBound(const Item *items, Index size, const Item &item, Less &less) {
+      if (size == 0) return 0;
+      const Item *base = items;
+      for (Index n = size; n > 1; ) {
+        Index half = n / 2;
+        base = less(base[half], item) ? base + half : base;
+        n -= half;
+      }
+      return (Index)(base - items) + (less(*base, item) ? 1 : 0);
+    }
+    
+    template <typename Less>
+    Index upperBound(const Item *items, Index size, const Item &item, Less &less) {
+      if (size == 0) return 0;
+      const Item *base = items;
+      for (Index n = size; n > 1; ) {
+        Index half = n / 2;
+        base = !less(item, base[half]) ? base + half : base;
+        n -= half;
+      }
+      return (Index)(base - items) + (!less(item, *base) ? 1 : 0);
+    }
+  };
+  
+  /**
+   * searches a copy of the items in Eytzinger (breadth first tree) order,
+   * where the children of the item k are at 2k and 2k + 1. The items of the
+   * next levels are close to each other, so they can be prefetched. This
+   * only pays off for vectors that are much bigger than the last level
+   * cache, for smaller ones BranchlessSearch is faster. The copy (and the
+   * position of every item) is built by the first search after the vector
+   * was changed, so it also needs many lookups between the changes.
+   */
+  template <typename Item, typename Index = int>
+  class EytzingerSearch {
+  private:
+    
+    /// the items in Eytzinger order, starting at 1
+    Vector<Item, Index> layout;
+    
+    /// the position of the items of the layout in the sorted items
+    Vector<Index, Index> positions;
+    
+    bool built;
+  
+  public:
+    
+    EytzingerSearch()
+    :layout(1), positions(1), built(false)
+    {}
+    
+    void invalidate() {
+      this->built = false;
+    }
+    
+    template <typename Less>
+    Index lowerBound(const Item *items, Index size, const Item &item, Less &less) {
+      if (size == 0) return 0;
+      this->build(items, size);
+      const Item *layout = this->layout.begin();
+      Index k = 1;
+      while (k <= size) {
+        this->prefetch(layout, k);
+        k = 2 * k + (less(layout[k], item) ? 1 : 0);
+      }
+      return this->position(k, size);
+    }
+    
+    template <typename Less>
+    Index upperBound(const Item *items, Index size, const Item &item, Less &less) {
+      if (size == 0) return 0;
+      this->build(items, size);
+      const Item *layout = this->layout.begin();
+      Index k = 1;
+      while (k <= size) {
+        this->prefetch(layout, k);
+        k = 2 * k + (!less(item, layout[k]) ? 1 : 0);
+      }
+      return this->position(k, size);
+    }
+  
+  private:
+    
+    /**
+     * returns the position of the item at which the search ended. The
+     * search turned right for every trailing 1 bit of k, the item is the
+     * one where it turned left the last time.
+     */
+    inline Index position(Index k, Index size) const {
+      while (k & 1) k >>= 1;
+      k >>= 1;
+      return k == 0 ? size : this->positions.begin()[k];
+    }
+    
+    /**
+     * prefetches the items 4 levels below k, which share a cache line for
+     * small items. For the last levels the address is behind the layout, so
+     * it is computed as an integer instead of a pointer. A prefetch doesn't
+     * fault, and there is no branch in the search loop.
+     */
+    inline void prefetch(const Item *layout, Index k) const {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch((const void *)((uintptr_t)layout + 16 * sizeof(Item) * (size_t)k));
+#endif
+    }
+    
+    void build(const Item *items, Index size) {
+      if (this->built) return;
+      this->layout.clear();
+      this->layout.fill(items[0], size + 1);
+      this->positions.clear();
+      this->positions.fill(0, size + 1);
+      this->place(items, 0, 1, size);
+      this->built = true;
+    }
+    
+    /**
+     * places the items in the subtree of k in order
+     * @return the position of the next item
+     */
+    Index place(const Item *items, Index position, Index k, Index size) {
+      if (k > size) return position;
+      position = this->place(items, position, 2 * k, size);
+      this->layout.begin()[k] = items[position];
+      this->positions.begin()[k] = position;
+      return this->place(items, position + 1, 2 * k + 1, size);
+    }
+  };
+  
+  /**
+   * a vector that keeps its items sorted, so that items are found in
+   * O(log N) instead of a linear scan. The items are ordered by the less
+   * predicate Compare (like std::less), single items are inserted behind
+   * the items equal to them. The search is done by the Search policy:
+   * BinarySearch, BranchlessSearch (the default) or EytzingerSearch. The
+   * EytzingerSearch changes its data on the first lookup after a change,
+   * so the first lookup must not run in parallel to others.
+   *
+   * Single items are inserted in O(N), batches of items are sorted and
+   * merged into the vector in a single pass, which is much faster than
+   * appending and sorting again. The items can only be read, as changing
+   * them could break the order.
+   */
+  template <typename Item, typename Index = int, typename Compare = std::less<Item>,
+            typename Search = BranchlessSearch<Item, Index> >
+  class SortedVector {
+  private:
+    
+    Vector<Item, Index> items;
+    
+    /// the search may build its data on the first lookup
+    mutable Compare compare;
+    mutable Search search;
+  
+  public:
+    
+    /**
+     * initialize an empty vector
+     * @param size the first initial max size for the vector
+     * @param compare the less predicate that orders the items
+     */
+    SortedVector(Index size = 10, Compare compare = Compare())
+    :items(size), compare(compare)
+    {}
+    
+    /**
+     * initialize the vector with the sorted copy of the items
+     */
+    SortedVector(const VectorView<Item, Index> &items, Compare compare = Compare())
+    :items(items.size() > 0 ? items.size() : 1), compare(compare)
+    {
+      this->insert(items);
+    }
+    
+    /**
+     * returns the size of the vector
+     */
+    Index size() const {
+      return this->items.size();
+    }
+    
+    /**
+     * returns true if the vector is empty
+     */
+    bool isEmpty() const {
+      return this->items.isEmpty();
+    }
+    
+    /**
+     * returns a view on the sorted items
+     */
+    VectorView<Item, Index> view() const {
+      return this->items.view();
+    }
+    
+    /**
+     * returns a lazy pipe over the sorted items, see Pipe
+     */
+    Pipe<PipeSource<Item>, Index> pipe() const {
+      return this->items.view().pipe();
+    }
+    
+    const Item *begin() const {
+      return this->items.begin();
+    }
+    
+    const Item *end() const {
+      return this->items.end();
+    }
+    
+    /**
+     * returns the item at the passed index
+     * @param index the index of the item, negative means Nth item before end
+     * @throws VectorAccessException if the index is out of range
+     */
+    const Item &at(const Index index) const {
+      return this->items.at(index);
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->items.at(index);
+    }
+    
+    /**
+     * returns the smallest item
+     * @throws VectorAccessException if the vector is empty
+     */
+    const Item &first() const {
+      return this->items.view().first();
+    }
+    
+    /**
+     * returns the biggest item
+     * @throws VectorAccessException if the vector is empty
+     */
+    const Item &last() const {
+      return this->items.view().last();
+    }
+    
+    /**
+     * returns the index of the first item that is not less than the item,
+     * which is size() if all items are less. O(log N)
+     */
+    Index lowerBound(const Item &item) const {
+      return this->search.lowerBound(this->items.begin(), this->items.size(), item,
+                                     this->compare);
+    }
+    
+    /**
+     * returns the index of the first item that is greater than the item,
+     * which is size() if no item is greater. O(log N)
+     */
+    Index upperBound(const Item &item) const {
+      return this->search.upperBound(this->items.begin(), this->items.size(), item,
+                                     this->compare);
+    }
+    
+    /**
+     * returns the index of the first item equal to the item or -1. O(log N)
+     */
+    Index find(const Item &item) const {
+      Index index = this->lowerBound(item);
+      if (index == this->items.size() ||
+          this->compare(item, this->items.begin()[index])) {
+        return -1;
+      }
+      return index;
+    }
+    
+    /**
+     * returns the range [first, second) of the items equal to the item.
+     * O(log N)
+     */
+    std::pair<Index, Index> equalRange(const Item &item) const {
+      return std::make_pair(this->lowerBound(item), this->upperBound(item));
+    }
+    
+    /**
+     * returns true if the item is in the vector. O(log N)
+     */
+    bool contains(const Item &item) const {
+      return this->find(item) >= 0;
+    }
+    
+    /**
+     * returns the number of items that are equal to the item. O(log N)
+     */
+    Index count(const Item &item) const {
+      std::pair<Index, Index> range = this->equalRange(item);
+      return range.second - range.first;
+    }
+    
+    /**
+     * inserts the item behind all equal items. O(N)
+     * @return the index of the inserted item
+     */
+    Index insert(const Item &item) {
+      Index index = this->upperBound(item);
+      this->items.insertAt(index, &item, 1);
+      this->search.invalidate();
+      return index;
+    }
+    
+    /**
+     * inserts the item, see insert
+     * @return self (the current vector) to enable chaining of <<
+     */
+    SortedVector<Item, Index, Compare, Search> &operator<<(const Item &item) {
+      this->insert(item);
+      return *this;
+    }
+    
+    /**
+     * inserts all items of the view. The items are sorted and merged with
+     * the items of the vector from the back, so every item is moved at most
+     * once. Equal items end up in the same order as inserting them one by
+     * one, the batch is sorted stable. O(N + M log M)
+     * @param items the items to insert, which may be items of this vector
+     */
+    void insert(const VectorView<Item, Index> &items) {
+      if (items.size() == 0) return;
+      Vector<Item, Index> batch = items.copy();
+      std::stable_sort(batch.begin(), batch.end(), this->compare);
+      
+      Index size = this->items.size();
+      this->items.append(batch);
+      this->search.invalidate();
+      if (size == 0) return;
+      
+      // merge from the back, equal items of the batch go behind the others
+      Item *elements = this->items.begin();
+      Item *added = batch.begin();
+      Index i = size - 1;
+      Index j = batch.size() - 1;
+      Index k = this->items.size() - 1;
+      while (j >= 0 && i >= 0) {
+        if (this->compare(added[j], elements[i])) {
+          elements[k--] = std::move(elements[i--]);
+        } else {
+          elements[k--] = std::move(added[j--]);
+        }
+      }
+      while (j >= 0) elements[k--] = std::move(added[j--]);
+    }
+    
+    template <typename Allocator, typename Bounds>
+    void insert(const Vector<Item, Index, Allocator, Bounds> &items) {
+      this->insert(items.view());
+    }
+    
+    /**
+     * removes the item at the passed index
+     * @return the item that was removed
+     */
+    Item removeAt(const Index index) {
+      Item item = this->items.removeAt(index);
+      this->search.invalidate();
+      return item;
+    }
+    
+    /**
+     * removes all items that are equal to the item. O(log N) to find them
+     * and O(N) to move the items behind them
+     * @return the count of deleted items
+     */
+    Index remove(const Item &item) {
+      std::pair<Index, Index> range = this->equalRange(item);
+      if (range.first == range.second) return 0;
+      
+      // the equal items are next to each other
+      this->items.removeRange(range.first, range.second - range.first);
+      this->search.invalidate();
+      return range.second - range.first;
+    }
+    
+    /**
+     * removes all items
+     */
+    void clear() {
+      this->items.clear();
+      this->search.invalidate();
+    }
+    
+    /**
+     * returns a string representation of the vector
+     */
+    std::string inspect() const {
+      std::string details;
+      Format::StringSink sink(details);
+      Format::details(sink, "Foundation::SortedVector", this, this->items.begin(),
+                      (size_t)this->items.size());
+      return details;
+    }
+    
+    /**
+     * returns a string representation of the sorted items
+     */
+    std::string toString() const {
+      return this->items.toString();
+    }
+  };
+};
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ *  stats.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_STATS
+#define FOUNDATION_STATS
+
+#include <atomic>
+#include <sstream>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace Foundation {
+  /**
+   * a snapshot of the counters of one vector or of all vectors of the
+   * process. The counters are only collected if FOUNDATION_VECTOR_STATS is
+   * defined before vector.h is included (for the whole program, as it
+   * changes the layout of the vectors). Otherwise counting does nothing and
+   * all counters are 0.
+   */
+  struct VectorStats {
+    /// the number of times the elements were resized
+    uint64_t reallocations;
+    
+    /// the bytes requested from and given back to the allocator
+    uint64_t allocatedBytes;
+    uint64_t freedBytes;
+    
+    /// the bytes of items that were copied or shifted (growing, removeAt,
+    /// insertAt, removing and copying items in)
+    uint64_t movedBytes;
+    
+    /// the comparisons done by sort, sortParallel is not counted
+    uint64_t comparisons;
+    
+    /// the max bytes of elements allocated and used by items, for the
+    /// process this is the max of any single vector
+    uint64_t peakCapacityBytes;
+    uint64_t peakSizeBytes;
+    
+    VectorStats()
+    :reallocations(0), allocatedBytes(0), freedBytes(0), movedBytes(0),
+     comparisons(0), peakCapacityBytes(0), peakSizeBytes(0)
+    {}
+    
+    /**
+     * returns true if the counters are collected
+     */
+    static bool enabled() {
+#ifdef FOUNDATION_VECTOR_STATS
+      return true;
+#else
+      return false;
+#endif
+    }
+    
+    /**
+     * returns the counters of all vectors of the process since the start
+     * or the last reset
+     */
+    static VectorStats process() {
+      Global &global = VectorStats::global();
+      VectorStats stats;
+      stats.reallocations = global.reallocations.load(std::memory_order_relaxed);
+      stats.allocatedBytes = global.allocatedBytes.load(std::memory_order_relaxed);
+      stats.freedBytes = global.freedBytes.load(std::memory_order_relaxed);
+      stats.movedBytes = global.movedBytes.load(std::memory_order_relaxed);
+      stats.comparisons = global.comparisons.load(std::memory_order_relaxed);
+      stats.peakCapacityBytes = global.peakCapacityBytes.load(std::memory_order_relaxed);
+      stats.peakSizeBytes = global.peakSizeBytes.load(std::memory_order_relaxed);
+      return stats;
+    }
+    
+    /**
+     * sets the counters of the process to 0
+     */
+    static void resetProcess() {
+      Global &global = VectorStats::global();
+      global.reallocations.store(0, std::memory_order_relaxed);
+      global.allocatedBytes.store(0, std::memory_order_relaxed);
+      global.freedBytes.store(0, std::memory_order_relaxed);
+      global.movedBytes.store(0, std::memory_order_relaxed);
+      global.comparisons.store(0, std::memory_order_relaxed);
+      global.peakCapacityBytes.store(0, std::memory_order_relaxed);
+      global.peakSizeBytes.store(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * returns the counters as a json object
+     */
+    std::string toJson() const {
+      std::ostringstream json;
+      json << "{\"enabled\": " << (VectorStats::enabled() ? "true" : "false")
+           << ", \"reallocations\": " << this->reallocations
+           << ", \"allocatedBytes\": " << this->allocatedBytes
+           << ", \"freedBytes\": " << this->freedBytes
+           << ", \"movedBytes\": " << this->movedBytes
+           << ", \"comparisons\": " << this->comparisons
+           << ", \"peakCapacityBytes\": " << this->peakCapacityBytes
+           << ", \"peakSizeBytes\": " << this->peakSizeBytes << "}";
+      return json.str();
+    }
+  
+  private:
+    
+    friend class VectorCounters;
+    
+    /// the counters of the process, updated by every vector
+    struct Global {
+      std::atomic<uint64_t> reallocations;
+      std::atomic<uint64_t> allocatedBytes;
+      std::atomic<uint64_t> freedBytes;
+      std::atomic<uint64_t> movedBytes;
+      std::atomic<uint64_t> comparisons;
+      std::atomic<uint64_t> peakCapacityBytes;
+      std::atomic<uint64_t> peakSizeBytes;
+    };
+    
+    static Global &global() {
+      static Global global = { {0}, {0}, {0}, {0}, {0}, {0}, {0} };
+      return global;
+    }
+  };
+  
+  /**
+   * the counters of a vector, which is the base class of Vector. All
+   * methods are inline and empty if the counters are disabled, the class
+   * is empty then and doesn't change the size of the vector. Copies start
+   * with new counters.
+   */
+  class VectorCounters {
+#ifdef FOUNDATION_VECTOR_STATS
+  private:
+    
+    VectorStats counters;
+#endif
+  
+  public:
+    
+    VectorCounters() {}
+    
+    VectorCounters(const VectorCounters &) {}
+    
+    VectorCounters &operator=(const VectorCounters &) {
+      return *this;
+    }
+    
+    /**
+     * returns the counters of this vector
+     */
+    VectorStats stats() const {
+#ifdef FOUNDATION_VECTOR_STATS
+      return this->counters;
+#else
+      return VectorStats();
+#endif
+    }
+    
+    /**
+     * sets the counters of this vector to 0
+     */
+    void resetStats() {
+#ifdef FOUNDATION_VECTOR_STATS
+      this->counters = VectorStats();
+#endif
+    }
+  
+  protected:
+    
+#ifdef FOUNDATION_VECTOR_STATS
+    inline void countAllocation(size_t bytes) {
+      this->counters.allocatedBytes += bytes;
+      VectorStats::global().allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    
+    inline void countFree(size_t bytes) {
+      this->counters.freedBytes += bytes;
+      VectorStats::global().freedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    
+    inline void countReallocation() {
+      this->counters.reallocations++;
+      VectorStats::global().reallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    inline void countMove(size_t bytes) {
+      this->counters.movedBytes += bytes;
+      VectorStats::global().movedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    
+    inline void countComparisons(uint64_t comparisons) {
+      this->counters.comparisons += comparisons;
+      VectorStats::global().comparisons.fetch_add(comparisons, std::memory_order_relaxed);
+    }
+    
+    inline void countCapacity(size_t bytes) {
+      if (bytes <= this->counters.peakCapacityBytes) return;
+      this->counters.peakCapacityBytes = bytes;
+      VectorCounters::raise(VectorStats::global().peakCapacityBytes, bytes);
+    }
+    
+    inline void countSize(size_t bytes) {
+      if (bytes <= this->counters.peakSizeBytes) return;
+      this->counters.peakSizeBytes = bytes;
+      VectorCounters::raise(VectorStats::global().peakSizeBytes, bytes);
+    }
+#else
+    inline void countAllocation(size_t) {}
+    inline void countFree(size_t) {}
+    inline void countReallocation() {}
+    inline void countMove(size_t) {}
+    inline void countComparisons(uint64_t) {}
+    inline void countCapacity(size_t) {}
+    inline void countSize(size_t) {}
+#endif
+  
+  private:
+    
+    /**
+     * sets the peak to value, if the value is bigger
+     */
+    static void raise(std::atomic<uint64_t> &peak, uint64_t value) {
+      uint64_t current = peak.load(std::memory_order_relaxed);
+      while (current < value &&
+             !peak.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+  };
+  
+  /**
+   * counts the calls of a less predicate, which is used by sort if the
+   * counters are enabled
+   */
+  template <typename Item, typename Less>
+  struct CountedLess {
+    Less &less;
+    uint64_t count;
+    
+    CountedLess(Less &less)
+    :less(less), count(0)
+    {}
+    
+    inline bool operator()(const Item &left, const Item &right) {
+      this->count++;
+      return this->less(left, right);
+    }
+  };
+};
+
+#endif
@@ -24,6 +24,7 @@ namespace Foundation {
       const int line;
       const T expectation;
       const T value;
+      std::string message;
       
       AssertionException(const char * expectationText, T expectation, 
                          const char * valueText, T value, 
@@ -33,14 +34,18 @@ namespace Foundation {
       :expectationText(expectationText), expectation(expectation), 
        valueText(valueText), value(value), 
        file(file), function(function), line(line)
-      {}
-      
-      const char* what() const throw() {
+      {
         std::ostringstream error;
         error << this->file << ":" << this->line
         << " " << this->function << "(): expected '" 
         << this->expectation << "' but got '" << this->value << "'";
-        return error.str().c_str();
+        this->message = error.str();
+      }
+      
+      ~AssertionException() throw() {}
+      
+      const char* what() const throw() {
+        return this->message.c_str();
       }
     };
     
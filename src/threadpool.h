@@ -0,0 +1,282 @@
+/*
+ *  threadpool.h
+ *  foundation-cpp
+ *
+ *  Copyright 2010 Vincent Landgraf. All rights reserved.
+ *
+ */
+#ifndef FOUNDATION_THREADPOOL
+#define FOUNDATION_THREADPOOL
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Foundation {
+  class ThreadPool;
+  
+  /**
+   * a group of tasks that were submitted to a thread pool. The group is used
+   * to wait for all of its tasks to finish.
+   */
+  class TaskGroup {
+    friend class ThreadPool;
+  
+  private:
+    
+    /// the number of tasks of the group that didn't finish yet
+    std::atomic<long> pending;
+    
+    /// the first exception that was thrown by a task of the group
+    std::exception_ptr error;
+    
+    /// protects the error
+    std::mutex errorLock;
+  
+  public:
+    
+    TaskGroup()
+    :pending(0)
+    {}
+    
+    /**
+     * returns true if all tasks of the group are finished
+     */
+    bool isDone() const {
+      return this->pending.load(std::memory_order_acquire) == 0;
+    }
+  };
+  
+  /**
+   * a work stealing thread pool. Every worker has its own queue of tasks.
+   * Tasks that are submitted by a worker are put in its own queue and are
+   * processed last in first out, idle workers steal the oldest tasks from
+   * the other queues. Threads that wait for a task group help processing
+   * tasks, so tasks may submit and wait for other tasks without deadlocks.
+   */
+  class ThreadPool {
+  public:
+    
+    typedef std::function<void()> Task;
+  
+  private:
+    
+    struct Job {
+      Task task;
+      TaskGroup *group;
+    };
+    
+    struct Queue {
+      std::mutex lock;
+      std::deque<Job> jobs;
+    };
+    
+    /// the worker threads of the pool
+    std::vector<std::thread> workers;
+    
+    /// one queue per worker and one for the threads outside of the pool
+    Queue *queues;
+    
+    /// the number of queues (workers + 1)
+    unsigned queueCount;
+    
+    /// the number of jobs in all queues
+    std::atomic<long> queued;
+    
+    /// set when the pool is destroyed
+    std::atomic<bool> stopping;
+    
+    /// used to put idle workers to sleep
+    std::mutex sleepLock;
+    std::condition_variable wakeup;
+  
+  public:
+    
+    /**
+     * creates a pool with the passed number of worker threads. The threads
+     * that wait for tasks take part in the work, so a pool with N - 1
+     * workers keeps N cores busy.
+     * @param workers the number of worker threads to start
+     */
+    ThreadPool(unsigned workers)
+    :queues(new Queue[workers + 1]), queueCount(workers + 1),
+     queued(0), stopping(false)
+    {
+      for (unsigned i = 0; i < workers; ++i) {
+        this->workers.push_back(std::thread(&ThreadPool::work, this, i));
+      }
+    }
+    
+    /**
+     * stops and joins all workers
+     */
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(this->sleepLock);
+        this->stopping = true;
+      }
+      this->wakeup.notify_all();
+      for (size_t i = 0; i < this->workers.size(); ++i) {
+        this->workers[i].join();
+      }
+      delete[] this->queues;
+    }
+    
+    /**
+     * returns the pool that is shared by the library. It keeps all cores of
+     * the machine busy and is created on first use.
+     */
+    static ThreadPool &shared() {
+      static ThreadPool pool(defaultWorkers());
+      return pool;
+    }
+    
+    /**
+     * returns the number of threads that work on the tasks, which are the
+     * workers and the waiting thread
+     */
+    unsigned size() const {
+      return (unsigned)this->workers.size() + 1;
+    }
+    
+    /**
+     * submits the task to the pool as part of the passed group
+     * @param group the group to add the task to
+     * @param task the task that will be executed by the pool
+     */
+    void submit(TaskGroup &group, Task task) {
+      group.pending.fetch_add(1, std::memory_order_relaxed);
+      
+      Queue &queue = this->queues[this->currentQueue()];
+      {
+        std::lock_guard<std::mutex> lock(queue.lock);
+        Job job = { task, &group };
+        queue.jobs.push_back(job);
+      }
+      this->queued.fetch_add(1, std::memory_order_release);
+      
+      if (!this->workers.empty()) {
+        this->wakeup.notify_one();
+      }
+    }
+    
+    /**
+     * waits until all tasks of the group are finished. The calling thread
+     * processes tasks while waiting. If a task of the group throws, the
+     * first exception is rethrown here.
+     * @param group the group to wait for
+     */
+    void wait(TaskGroup &group) {
+      unsigned queue = this->currentQueue();
+      while (!group.isDone()) {
+        if (!this->runOne(queue)) {
+          std::this_thread::yield();
+        }
+      }
+      
+      if (group.error) {
+        std::exception_ptr error = group.error;
+        group.error = std::exception_ptr();
+        std::rethrow_exception(error);
+      }
+    }
+  
+  protected:
+    
+    /**
+     * returns the number of workers for the shared pool
+     */
+    static unsigned defaultWorkers() {
+      unsigned cores = std::thread::hardware_concurrency();
+      return cores > 1 ? cores - 1 : 0;
+    }
+    
+    /**
+     * returns a reference to the pool and queue the current thread belongs
+     * to. Threads outside of any pool have no pool.
+     */
+    static ThreadPool *&currentPool() {
+      static thread_local ThreadPool *pool = NULL;
+      return pool;
+    }
+    
+    static unsigned &currentIndex() {
+      static thread_local unsigned index = 0;
+      return index;
+    }
+    
+    /**
+     * returns the queue the current thread uses for its tasks
+     */
+    unsigned currentQueue() {
+      if (currentPool() == this) return currentIndex();
+      return this->queueCount - 1;
+    }
+    
+    /**
+     * takes a job from the own queue (newest first) or steals one from the
+     * other queues (oldest first) and runs it.
+     * @param self the index of the own queue
+     * @return true if a job was run
+     */
+    bool runOne(unsigned self) {
+      Job job;
+      bool found = false;
+      
+      if (this->queued.load(std::memory_order_acquire) == 0) return false;
+      
+      for (unsigned i = 0; i < this->queueCount && !found; ++i) {
+        Queue &queue = this->queues[(self + i) % this->queueCount];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (queue.jobs.empty()) continue;
+        
+        if (i == 0) {
+          job = queue.jobs.back();
+          queue.jobs.pop_back();
+        } else {
+          job = queue.jobs.front();
+          queue.jobs.pop_front();
+        }
+        found = true;
+      }
+      
+      if (!found) return false;
+      this->queued.fetch_sub(1, std::memory_order_relaxed);
+      
+      try {
+        job.task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job.group->errorLock);
+        if (!job.group->error) job.group->error = std::current_exception();
+      }
+      job.group->pending.fetch_sub(1, std::memory_order_release);
+      return true;
+    }
+    
+    /**
+     * the loop of every worker thread
+     * @param index the index of the queue of the worker
+     */
+    void work(unsigned index) {
+      currentPool() = this;
+      currentIndex() = index;
+      
+      while (!this->stopping) {
+        if (!this->runOne(index)) {
+          std::unique_lock<std::mutex> lock(this->sleepLock);
+          this->wakeup.wait_for(lock, std::chrono::milliseconds(1), [this] {
+            return this->stopping || this->queued.load() > 0;
+          });
+        }
+      }
+    }
+  };
+};
+
+#endif
@@ -9,14 +9,37 @@
 #ifndef FOUNDATION_VECTOR
 #define FOUNDATION_VECTOR
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
 #include <sstream>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "format.h"
+#include "pipe.h"
+#include "serialization.h"
+#include "simd.h"
+#include "stats.h"
+#include "threadpool.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FOUNDATION_COLD __attribute__((noinline, cold))
+#else
+#define FOUNDATION_COLD
+#endif
 
 namespace Foundation {
   template <typename Item>
   inline void swap(Item &left, Item &right) {
-    Item tmp = left;
-    left = right;
-    right = tmp;
+    Item tmp = std::move(left);
+    left = std::move(right);
+    right = std::move(tmp);
   }
   
   template <typename Item>
@@ -26,55 +49,509 @@ namespace Foundation {
     else return 1;
   }
   
-  template <typename Item, typename Index = int>
+  /// the unsigned integer type with the passed size in bytes
+  template <size_t size> struct UnsignedOfSize {};
+  template <> struct UnsignedOfSize<1> { typedef uint8_t Type; };
+  template <> struct UnsignedOfSize<2> { typedef uint16_t Type; };
+  template <> struct UnsignedOfSize<4> { typedef uint32_t Type; };
+  template <> struct UnsignedOfSize<8> { typedef uint64_t Type; };
+  
+  /**
+   * maps items to unsigned keys that have the same order as the items using
+   * defaultCompare. Only integral and IEEE floating point types are enabled, 
+   * the vector uses a radix sort on the keys for them.
+   */
+  template <typename Item, typename Enable = void>
+  struct RadixKey {
+    static const bool enabled = false;
+    typedef uint8_t Key;
+    static Key of(const Item &item) { return 0; }
+  };
+  
+  template <typename Item>
+  struct RadixKey<Item, typename std::enable_if<
+    std::is_integral<Item>::value && !std::is_same<Item, bool>::value
+  >::type> {
+    static const bool enabled = true;
+    typedef typename UnsignedOfSize<sizeof(Item)>::Type Key;
+    
+    static Key of(const Item &item) {
+      Key key;
+      memcpy(&key, &item, sizeof(Key));
+      // move the negative numbers in front of the positive ones
+      if (std::is_signed<Item>::value) key ^= (Key)1 << (sizeof(Key) * 8 - 1);
+      return key;
+    }
+  };
+  
+  template <typename Item>
+  struct RadixKey<Item, typename std::enable_if<
+    std::is_floating_point<Item>::value && std::numeric_limits<Item>::is_iec559 &&
+    (sizeof(Item) == 4 || sizeof(Item) == 8)
+  >::type> {
+    static const bool enabled = true;
+    typedef typename UnsignedOfSize<sizeof(Item)>::Type Key;
+    
+    static Key of(const Item &item) {
+      Key key;
+      memcpy(&key, &item, sizeof(Key));
+      // negative numbers are stored as sign and magnitude, so all bits are
+      // flipped to reverse their order, positive numbers only get the sign 
+      // bit set to move them behind the negative ones (and -0.0)
+      Key sign = (Key)1 << (sizeof(Key) * 8 - 1);
+      return (key & sign) ? ~key : key | sign;
+    }
+  };
+  
+  /**
+   * turns a compare function (returning < 0, 0 or > 0 like defaultCompare) 
+   * or a less predicate (returning bool like std::less) into the less
+   * predicate that is used by the sort of the vector.
+   */
+  template <typename Item, typename Compare, bool isLess = std::is_same<
+    decltype(std::declval<Compare &>()(std::declval<const Item &>(), 
+                                       std::declval<const Item &>())), bool
+  >::value>
+  struct SortLess {
+    Compare &compare;
+    
+    SortLess(Compare &compare)
+    :compare(compare)
+    {}
+    
+    inline bool operator()(const Item &left, const Item &right) {
+      return this->compare(left, right) < 0;
+    }
+  };
+  
+  template <typename Item, typename Compare>
+  struct SortLess<Item, Compare, true> {
+    Compare &compare;
+    
+    SortLess(Compare &compare)
+    :compare(compare)
+    {}
+    
+    inline bool operator()(const Item &left, const Item &right) {
+      return this->compare(left, right);
+    }
+  };
+  
+  struct Checked;
+  struct Unchecked;
+  
+  template <typename Item, typename Index = int, 
+            typename Allocator = MallocAllocator, typename Bounds = Checked>
   class Vector;
   
+  template <typename Item, typename Index = int>
+  class VectorView;
+  
   template <typename Item, typename Index = int>
   class VectorAccessException : public std::exception {
   private:
     
-    char * msg;
-    
+    std::string msg;
+  
   public:
     
     VectorAccessException(Vector<Item, Index> *vector, Index index)
     :std::exception()
     {
+      this->describe(vector->size(), index);
+    }
+    
+    VectorAccessException(Index size, Index index)
+    :std::exception()
+    {
+      this->describe(size, index);
+    }
+    
+    virtual ~VectorAccessException() throw() {}
+    
+    virtual const char* what() const throw() {
+      return this->msg.c_str();
+    };
+  
+  protected:
+    
+    /**
+     * constructs the message for an access to a vector of the passed size
+     * at index
+     */
+    void describe(Index size, Index index) {
       std::ostringstream error;
       
       // construct the message using the error string stream
       error << "You tried to access the vector("
-            << vector->size() << ") at index " << index;
-      if (vector->isEmpty()) {
+            << size << ") at index " << index;
+      if (size == 0) {
         // error because of empty vector
         error << " but it is empty!";
       } else {
         // error because of bad access
-        Index from = -(vector->size()) + 1;
+        Index from = -size + 1;
         error << " but it is only being allowed between "
-              << from << " and " << vector->size() << "!";
+              << from << " and " << size << "!";
       }
       
-      // store the message in the char * msg
-      std::string msgString = error.str();
-      this->msg = new char[msgString.size()];
-      memcpy(this->msg, msgString.c_str(), msgString.size());
+      this->msg = error.str();
+    }
+  };
+  
+  /**
+   * the bounds check policy of a vector, which decides what at(), [],
+   * first() and last() do with an index. Both policies translate negative
+   * indexes to a count from the end.
+   */
+  struct Checked {
+    /**
+     * returns the index in the elements
+     * @throws VectorAccessException if the index is out of range
+     */
+    template <typename Item, typename Index>
+    static inline Index index(Index index, Index size) {
+      if (index < 0) index = size + index;
+      if (index < 0 || index >= size) Checked::fail<Item, Index>(size, index);
+      return index;
     }
     
-    virtual const char* what() const throw() {
-      return this->msg;
-    };
+    /**
+     * throws the exception, which is kept out of the inlined accessors
+     */
+    template <typename Item, typename Index>
+    [[noreturn]] FOUNDATION_COLD static void fail(Index size, Index index) {
+      throw VectorAccessException<Item, Index>(size, index);
+    }
   };
   
+  /**
+   * doesn't check the index at all, so that loops over the items compile
+   * to the same code as loops over a plain array. Accessing an index out
+   * of range is undefined behaviour. Only the accessors use the policy, 
+   * slice, removeAt and all other methods still check their indexes.
+   */
+  struct Unchecked {
+    template <typename Item, typename Index>
+    static inline Index index(Index index, Index size) {
+      return index < 0 ? size + index : index;
+    }
+  };
+  
+  /**
+   * a view on a range of the elements of a vector. The view doesn't own or
+   * copy the elements, it's only valid as long as the vector isn't changed
+   * in size or destroyed. Slicing a view returns another view.
+   */
   template <typename Item, typename Index>
-  class Vector {
+  class VectorView {
+  private:
+    
+    /// the first element of the view
+    const Item * elements;
+    
+    /// the number of elements in the view
+    Index elementsSize;
+  
+  public:
+    
+    /**
+     * creates a view on the passed elements
+     * @param elements the first element of the view
+     * @param size the number of elements in the view
+     */
+    VectorView(const Item * elements = NULL, Index size = 0)
+    :elements(elements), elementsSize(size)
+    {}
+    
+    /**
+     * returns the size of the view
+     * @return number of elements
+     */
+    Index size() const {
+      return this->elementsSize;
+    }
+    
+    /**
+     * returns true if the view is empty
+     */
+    bool isEmpty() const {
+      return this->elementsSize == 0;
+    }
+    
+    /**
+     * returns the first element of the view
+     * @throws VectorAccessException if the view is empty
+     */
+    const Item &first() const {
+      return this->elements[this->indexFor(0)];
+    }
+    
+    /**
+     * returns the last element of the view
+     * @throws VectorAccessException if the view is empty
+     */
+    const Item &last() const {
+      return this->elements[this->indexFor(-1)];
+    }
+    
+    /**
+     * returns a reference to the element a the passed index.
+     * @param index the index to get the item from. The index may be negative 
+     *              and will be converted in Nth item before the end.
+     */
+    const Item &at(const Index index) const {
+      return this->elements[this->indexFor(index)];
+    }
+    
+    const Item &operator[](const Index index) const {
+      return this->at(index);
+    }
+    
+    /**
+     * returns the position of the first occurance of the item in the view
+     * or -1 if nothing was found
+     */
+    Index index(const Item item) const {
+      return (Index)Simd::find(this->elements, (size_t)this->elementsSize, item);
+    }
+    
+    /**
+     * returns the position of the last occurance of the item in the view
+     * or -1 if nothing was found
+     */
+    Index lastIndex(const Item item) const {
+      return (Index)Simd::findLast(this->elements, (size_t)this->elementsSize, item);
+    }
+    
+    /**
+     * returns true if the item is in the view
+     */
+    bool contains(const Item item) const {
+      return this->index(item) >= 0;
+    }
+    
+    /**
+     * returns the number of items in the view that are equal to item
+     */
+    Index count(const Item item) const {
+      return (Index)Simd::count(this->elements, (size_t)this->elementsSize, item);
+    }
+    
+    /**
+     * returns the sum of the items, 0 for an empty view. Integral items are
+     * summed up as 64 bit integers, floating point items as double. Views of
+     * numbers are summed using SSE2 or AVX2 depending on the cpu.
+     */
+    typename Simd::SumOf<Item>::Type sum() const {
+      return Simd::sum(this->elements, (size_t)this->elementsSize);
+    }
+    
+    /**
+     * returns the smallest item, the first one if there are equal ones
+     * @throws VectorAccessException if the view is empty
+     */
+    Item min() const {
+      this->indexFor(0);
+      return Simd::min(this->elements, (size_t)this->elementsSize);
+    }
+    
+    /**
+     * returns the biggest item, the first one if there are equal ones
+     * @throws VectorAccessException if the view is empty
+     */
+    Item max() const {
+      this->indexFor(0);
+      return Simd::max(this->elements, (size_t)this->elementsSize);
+    }
+    
+    /**
+     * returns the smallest and the biggest item in one pass
+     * @throws VectorAccessException if the view is empty
+     */
+    std::pair<Item, Item> minmax() const {
+      this->indexFor(0);
+      std::pair<Item, Item> extremes;
+      Simd::minmax(this->elements, (size_t)this->elementsSize, 
+                   extremes.first, extremes.second);
+      return extremes;
+    }
+    
+    /**
+     * returns the index of the first smallest item or -1 for an empty view
+     */
+    Index argmin() const {
+      if (this->elementsSize == 0) return -1;
+      return this->indexOfExtreme(this->min());
+    }
+    
+    /**
+     * returns the index of the first biggest item or -1 for an empty view
+     */
+    Index argmax() const {
+      if (this->elementsSize == 0) return -1;
+      return this->indexOfExtreme(this->max());
+    }
+    
+    /**
+     * returns the arithmetic mean of the items or NaN for an empty view
+     */
+    double mean() const {
+      if (this->elementsSize == 0) return std::numeric_limits<double>::quiet_NaN();
+      return (double)this->sum() / this->elementsSize;
+    }
+    
+    /**
+     * returns a view from the start index to the end of this view
+     * @param start the start index, may be negative
+     */
+    VectorView<Item, Index> slice(const Index start) const {
+      Index begin = this->indexFor(start);
+      return VectorView<Item, Index>(this->elements + begin, 
+                                     this->elementsSize - begin);
+    }
+    
+    /**
+     * returns a view from the start index with size elements. The same
+     * boundary checks as for Vector::slice apply.
+     * @param start the start index, may be negative
+     * @param size the number of elements in the new view
+     */
+    VectorView<Item, Index> slice(const Index start, const Index size) const {
+      Index begin = this->indexFor(start);
+      Index end = this->indexFor(start + size - 1);
+      if (end < begin) {
+        throw VectorAccessException<Item, Index>(this->elementsSize, end);
+      }
+      return VectorView<Item, Index>(this->elements + begin, size);
+    }
+    
+    /**
+     * returns a new vector with a copy of the elements of the view
+     */
+    Vector<Item, Index> copy() const {
+      Vector<Item, Index> vector(this->elementsSize > 0 ? this->elementsSize : 1);
+      vector.append(this->elements, this->elementsSize);
+      return vector;
+    }
+    
+    /**
+     * returns a lazy pipe over the items of the view, see Pipe
+     */
+    Pipe<PipeSource<Item>, Index> pipe() const {
+      return Pipe<PipeSource<Item>, Index>(
+        PipeSource<Item>(this->elements, (size_t)this->elementsSize));
+    }
+    
+    /**
+     * returns a pointer to the first element, to iterate over the view
+     */
+    const Item *begin() const {
+      return this->elements;
+    }
+    
+    /**
+     * returns a pointer behind the last element
+     */
+    const Item *end() const {
+      return this->elements + this->elementsSize;
+    }
+    
+    /**
+     * returns a string representation of view
+     */
+    std::string inspect() const {
+      std::string details;
+      details.reserve(64 + Format::estimate<Item>(this->elementsSize));
+      Format::StringSink sink(details);
+      Format::details(sink, "Foundation::VectorView", this, this->elements,
+                      (size_t)this->elementsSize);
+      return details;
+    }
+    
+    /**
+     * returns a string representation of the values of the view. Numbers
+     * are written without a stream into a string of the estimated size.
+     */
+    std::string toString() const {
+      std::string values;
+      values.reserve(Format::estimate<Item>(this->elementsSize));
+      Format::StringSink sink(values);
+      this->format(sink);
+      return values;
+    }
+    
+    /**
+     * writes the string representation of the values to the sink, see
+     * Format
+     * @param sink the object the text is appended to
+     */
+    template <typename Sink>
+    void format(Sink &sink) const {
+      Format::values(sink, this->elements, (size_t)this->elementsSize);
+    }
+    
+    /**
+     * writes the string representation of the values to the file
+     * descriptor, without building a string first
+     * @throws SerializationException if the write fails
+     */
+    void printTo(int fd) const {
+      Format::FileSink sink(fd);
+      this->format(sink);
+    }
+    
+    /**
+     * writes the items in the binary format (see Serialization) to the file
+     * descriptor. The header and the items are written by a single writev.
+     * @param fd the file descriptor to write to
+     * @throws SerializationException if the write fails
+     */
+    void writeTo(int fd) const {
+      static_assert(std::is_trivially_copyable<Item>::value,
+                    "only trivially copyable items can be written");
+      size_t bytes = (size_t)this->elementsSize * sizeof(Item);
+      Serialization::Checksum checksum;
+      checksum.update(this->elements, bytes);
+      Serialization::Header header = Serialization::header(
+        sizeof(Item), (uint64_t)this->elementsSize, checksum.value());
+      
+      struct iovec buffers[2];
+      buffers[0].iov_base = &header;
+      buffers[0].iov_len = sizeof(header);
+      buffers[1].iov_base = (void *)this->elements;
+      buffers[1].iov_len = bytes;
+      Serialization::writeAll(fd, buffers, bytes > 0 ? 2 : 1);
+    }
+  
+  protected:
+    
+    /**
+     * returns the index of the first item that equals the extreme. The
+     * extreme is only NaN (which equals nothing) if the first item is NaN.
+     */
+    Index indexOfExtreme(const Item &extreme) const {
+      Index found = this->index(extreme);
+      return found >= 0 ? found : 0;
+    }
+    
+    /**
+     * verifies and calculates the correct index like Vector::indexFor
+     */
+    inline Index indexFor(Index index) const {
+      return Checked::index<Item, Index>(index, this->elementsSize);
+    }
+  };
+  
+  template <typename Item, typename Index, typename Allocator, typename Bounds>
+  class Vector : public VectorCounters {
     /// this is the prototype for every mapping function accepred by this vector
     typedef Item (*mappingFunction)(const Item);
     
     /// this is the prototype for every compare function accepted by this vector
     typedef int (*compareFunction)(const Item &left, const Item &right);
-    
-  private:
+  
+  protected:
     
     /// the array that holds the elements of the vector
     Item * elements;
@@ -88,14 +565,40 @@ namespace Foundation {
      */
     Index elementsSize;
     
+    /// the allocator that is used for the elements array
+    Allocator allocator;
+    
+    /// partitions smaller than this will be sorted using insertion sort
+    static const int SORT_INSERTION_THRESHOLD = 16;
+    
+    /// partitions bigger than this will use the ninther to find a pivot
+    static const int SORT_NINTHER_THRESHOLD = 128;
+    
+    /// vectors smaller than this will not be sorted using the radix sort
+    static const int SORT_RADIX_THRESHOLD = 256;
+    
+    /// removeAll searches lists of items bigger than this using binary search
+    static const int REMOVE_SEARCH_THRESHOLD = 16;
+    
+    /// partitions smaller than this will not be split across threads
+    static const int SORT_PARALLEL_THRESHOLD = 1 << 14;
+    
+    /// the parallel operations split the vector in blocks of this size
+    static const int PARALLEL_BLOCK_BYTES = 1 << 16;
+    
+    /// items that can be moved using realloc and memcpy
+    static const bool TRIVIAL_ITEMS = std::is_trivially_copyable<Item>::value;
+  
   public:
     
     /**
      * initlalize the vector with a new max size
      * @param size the first initial max size for the vector
+     * @param allocator the allocator to use for the elements, by default
+     *                  malloc, realloc and free are used
      */
-    Vector(Index size = 10)
-    :elements(NULL), maxSize(size)
+    Vector(Index size = 10, const Allocator &allocator = Allocator())
+    :elements(NULL), maxSize(size), allocator(allocator)
     {
       this->clear();
     }
@@ -105,20 +608,83 @@ namespace Foundation {
      * generated vector will have exactly the size of the passed array.
      * @param array the array to copy in
      * @param size the size of the passed array
+     * @param allocator the allocator to use for the elements
+     */
+    Vector(Item * array, int size, const Allocator &allocator = Allocator())
+    :elements(NULL), maxSize(size), allocator(allocator)
+    {
+      this->clear();
+      this->construct(array, size);
+    }
+    
+    /**
+     * initialize the vector as a copy of the other vector. The copy has its
+     * own elements and a copy of the allocator of the other vector.
+     * @param other the vector to copy
      */
-    Vector(Item * array, int size)
-    :elements(NULL), maxSize(size)
+    Vector(const Vector<Item, Index, Allocator, Bounds> &other)
+    :VectorCounters(), elements(NULL), maxSize(other.maxSize), allocator(other.allocator)
     {
       this->clear();
-      memcpy(this->elements, array, sizeof(Item) * this->maxSize);
-      this->elementsSize = size;
+      this->construct(other.elements, other.elementsSize);
+    }
+    
+    /**
+     * initialize the vector with the elements of the other vector, which is
+     * empty afterwards. The elements are taken over without copying them,
+     * unless the allocator can't hand them over (see AllocatorTraits), then
+     * the items are moved one by one.
+     * @param other the vector to move
+     */
+    Vector(Vector<Item, Index, Allocator, Bounds> &&other)
+        noexcept(AllocatorTraits<Allocator>::transferable)
+    :elements(NULL), maxSize(0), elementsSize(0), allocator(other.allocator)
+    {
+      this->take(other, std::integral_constant<bool, AllocatorTraits<Allocator>::transferable>());
+    }
+    
+    /**
+     * replaces the elements of the vector with a copy of the elements of the
+     * other vector. The vector keeps its allocator.
+     * @param other the vector to copy
+     */
+    Vector<Item, Index, Allocator, Bounds> &operator=(const Vector<Item, Index, Allocator, Bounds> &other) {
+      if (this != &other) {
+        this->destroy(0, this->elementsSize);
+        this->deallocateElements(this->bytes());
+        this->elements = NULL;
+        this->maxSize = other.maxSize;
+        this->clear();
+        this->construct(other.elements, other.elementsSize);
+      }
+      return *this;
+    }
+    
+    /**
+     * replaces the elements of the vector with the elements of the other
+     * vector, which is empty afterwards. The elements and the allocator are
+     * taken over like by the move constructor.
+     * @param other the vector to move
+     */
+    Vector<Item, Index, Allocator, Bounds> &operator=(Vector<Item, Index, Allocator, Bounds> &&other)
+        noexcept(AllocatorTraits<Allocator>::transferable) {
+      if (this != &other) {
+        this->destroy(0, this->elementsSize);
+        this->deallocateElements(this->bytes());
+        this->elements = NULL;
+        this->maxSize = 0;
+        this->elementsSize = 0;
+        this->take(other, std::integral_constant<bool, AllocatorTraits<Allocator>::transferable>());
+      }
+      return *this;
     }
     
     /**
      * deletes the internal data structure that holds the data
      */
     ~Vector() {
-      free(this->elements);
+      this->destroy(0, this->elementsSize);
+      this->deallocateElements(this->bytes());
     }
     
     /**
@@ -141,7 +707,7 @@ namespace Foundation {
      * @throws VectorAccessException if the vector is empty
      */
     Item &last() {
-      return this->elements[this->indexFor(-1)];
+      return this->elements[this->accessFor(-1)];
     }
     
     /*
@@ -149,7 +715,14 @@ namespace Foundation {
      * @throws: VectorAccessException if the vector is empty
      */
     Item &first() {
-      return this->elements[this->indexFor(0)];
+      return this->elements[this->accessFor(0)];
+    }
+    
+    /**
+     * returns the number of items the vector can hold before it has to grow
+     */
+    Index capacity() const {
+      return this->maxSize;
     }
     
     /**
@@ -157,114 +730,695 @@ namespace Foundation {
      * @param item the item to add to the vector
      * @return self (the current vector) to enable chaining of <<
      */
-    Vector<Item, Index> &operator<<(const Item &item) {
+    Vector<Item, Index, Allocator, Bounds> &operator<<(const Item &item) {
+      this->emplace(item);
+      return *(this);
+    }
+    
+    /**
+     * adds an item to the vector by moving it in
+     * @param item the item to move to the vector
+     * @return self (the current vector) to enable chaining of <<
+     */
+    Vector<Item, Index, Allocator, Bounds> &operator<<(Item &&item) {
+      this->emplace(std::move(item));
+      return *(this);
+    }
+    
+    /**
+     * adds an item to the vector like <<
+     * @param item the item to add to the vector
+     */
+    Vector<Item, Index, Allocator, Bounds> &push(const Item &item) {
+      this->emplace(item);
+      return *(this);
+    }
+    
+    /**
+     * adds an item to the vector by moving it in, the item is not copied
+     * @param item the item to move to the vector
+     */
+    Vector<Item, Index, Allocator, Bounds> &push(Item &&item) {
+      this->emplace(std::move(item));
+      return *(this);
+    }
+    
+    /**
+     * constructs a new item at the end of the vector from the passed 
+     * arguments, so that the item doesn't have to be copied or moved.
+     * @param args the arguments for the constructor of the item
+     * @return a reference to the new item
+     */
+    template <typename... Args>
+    Item &emplace(Args &&... args) {
+      Item *item = this->elements + this->elementsSize;
       if (this->elementsSize >= this->maxSize) {
-        this->resizeTo(this->maxSize * 2);
+        // the arguments may refer to items of the vector, so the item is
+        // created before the elements are moved
+        Item created(std::forward<Args>(args)...);
+        this->grow();
+        item = new (this->elements + this->elementsSize) Item(std::move(created));
+      } else {
+        item = new (item) Item(std::forward<Args>(args)...);
+      }
+      this->elementsSize++;
+      this->countSize((size_t)this->elementsSize * sizeof(Item));
+      return *item;
+    }
+    
+    /**
+     * makes sure the vector can hold size items without growing
+     * @param size the number of items to make space for
+     */
+    void reserve(const Index size) {
+      if (size > this->maxSize) this->resizeTo(size);
+    }
+    
+    /**
+     * gives the space that is not used by items back to the allocator
+     */
+    void shrinkToFit() {
+      if (this->maxSize > this->elementsSize) this->resizeTo(this->elementsSize);
+    }
+    
+    /**
+     * adds all items of the array to the end of the vector. The vector grows
+     * at most once and trivial items are copied using a single memcpy.
+     * @param array the items to add, which may be items of the vector itself
+     * @param size the number of items in the array
+     * @return self (the current vector) to enable chaining
+     */
+    Vector<Item, Index, Allocator, Bounds> &append(const Item *array, const Index size) {
+      if (this->owns(array)) {
+        // the items are moved if the vector grows
+        Index offset = (Index)(array - this->elements);
+        this->ensureSpace(this->elementsSize + size);
+        array = this->elements + offset;
+      } else {
+        this->ensureSpace(this->elementsSize + size);
+      }
+      this->construct(array, size);
+      return *(this);
+    }
+    
+    /**
+     * adds all items of the view to the end of the vector
+     * @param items the items to add
+     */
+    Vector<Item, Index, Allocator, Bounds> &append(const VectorView<Item, Index> &items) {
+      return this->append(items.begin(), items.size());
+    }
+    
+    /**
+     * adds all items of the other vector to the end of the vector
+     * @param other the vector whose items will be added, may be the vector
+     *              itself
+     */
+    template <typename OtherAllocator, typename OtherBounds>
+    Vector<Item, Index, Allocator, Bounds> &append(const Vector<Item, Index, OtherAllocator, OtherBounds> &other) {
+      return this->append(other.view());
+    }
+    
+    /**
+     * adds size copies of the value to the end of the vector
+     * @param value the value of the new items
+     * @param size the number of items to add
+     * @return self (the current vector) to enable chaining
+     */
+    Vector<Item, Index, Allocator, Bounds> &fill(const Item &value, const Index size) {
+      // the value may be an item of the vector, which is moved on growing
+      const Item item(value);
+      this->ensureSpace(this->elementsSize + size);
+      std::uninitialized_fill_n(this->elements + this->elementsSize, size, item);
+      this->elementsSize += size;
+      this->countSize((size_t)this->elementsSize * sizeof(Item));
+      return *(this);
+    }
+    
+    /**
+     * inserts all items of the array before the item at the passed index.
+     * The items behind the index are moved only once, for trivial items the
+     * insert is a memmove and a memcpy.
+     * @param index the index the first item of the array will have. This can
+     *              be a positive or negative index, negative means Nth item
+     *              before end. The size of the vector inserts at the end.
+     * @param array the items to insert
+     * @param size the number of items in the array
+     * @return self (the current vector) to enable chaining
+     */
+    Vector<Item, Index, Allocator, Bounds> &insertAt(Index index, const Item *array, const Index size) {
+      if (index < 0) index = this->elementsSize + index;
+      if (index < 0 || index > this->elementsSize)
+        throw VectorAccessException<Item, Index>(this->elementsSize, index);
+      
+      if (this->owns(array)) {
+        // the items would be moved while inserting
+        Vector<Item, Index> items(size > 0 ? size : 1);
+        items.append(array, size);
+        return this->insertAt(index, items.view().begin(), size);
+      }
+      
+      Index oldSize = this->elementsSize;
+      if (!TRIVIAL_ITEMS) {
+        // append and rotate the new items into place
+        this->append(array, size);
+        std::rotate(this->elements + index, this->elements + oldSize, 
+                    this->elements + this->elementsSize);
+        this->countMove((size_t)(this->elementsSize - index) * sizeof(Item));
+        return *(this);
       }
-      this->at(this->elementsSize++) = item;
       
+      this->ensureSpace(oldSize + size);
+      memmove((void *)(this->elements + index + size), (void *)(this->elements + index),
+              sizeof(Item) * (oldSize - index));
+      memcpy((void *)(this->elements + index), (const void *)array, sizeof(Item) * size);
+      this->elementsSize += size;
+      this->countMove(sizeof(Item) * (oldSize - index + size));
+      this->countSize((size_t)this->elementsSize * sizeof(Item));
       return *(this);
     }
     
+    /**
+     * inserts all items of the view before the item at the passed index
+     * @param index the index the first item of the view will have
+     * @param items the items to insert
+     */
+    Vector<Item, Index, Allocator, Bounds> &insertAt(const Index index, const VectorView<Item, Index> &items) {
+      return this->insertAt(index, items.begin(), items.size());
+    }
+    
     /**
      * returns a reference to the element a the passed index.
      * @param index the index to get the item from. The index may be negative 
      *              and will be converted in Nth item before the end.
      */
     Item &at(const Index index) {
-      return this->elements[this->indexFor(index)];
+      return this->elements[this->accessFor(index)];
+    }
+    
+    const Item &at(const Index index) const {
+      return this->elements[this->accessFor(index)];
+    }
+    
+    /**
+     * returns a reference to the element at the passed index without any
+     * check, the index has to be between 0 and size() - 1
+     */
+    inline Item &uncheckedAt(const Index index) {
+      return this->elements[index];
+    }
+    
+    inline const Item &uncheckedAt(const Index index) const {
+      return this->elements[index];
     }
     
     /*
      * searches for the item in the vector and returns the first occurance
-     * if nothing was found -1 will be returned
+     * if nothing was found -1 will be returned. Vectors of numbers are
+     * searched using SSE2 or AVX2 depending on the cpu.
      * @param item the item to search for
      * @return -1 for nothing, otherwiese a positive index
      */
     Index index(const Item item) const {
-      for (Index i = 0; i < this->elementsSize; ++i) {
-        if (this->elements[i] == item) {
-          return i;
-        }
-      }
-      return -1;
+      return (Index)Simd::find(this->elements, (size_t)this->elementsSize, item);
     }
     
     /*
      * searches for the item in the vector and returns the last occurance
-     * if nothing was found -1 will be returned
+     * if nothing was found -1 will be returned. The search starts at the end
+     * of the vector.
      * @param item the item to search for
      * @return -1 for nothing, otherwiese a positive index
      */
-    Index lastIndex(const Item item) {
-      Index found = -1;
+    Index lastIndex(const Item item) const {
+      return (Index)Simd::findLast(this->elements, (size_t)this->elementsSize, item);
+    }
+    
+    /*
+     * returns true if the item is in the vector
+     * @param item the item to search for
+     */
+    bool contains(const Item item) const {
+      return this->index(item) >= 0;
+    }
+    
+    /*
+     * returns the number of items in the vector that are equal to item
+     * @param item the item to count
+     */
+    Index count(const Item item) const {
+      return (Index)Simd::count(this->elements, (size_t)this->elementsSize, item);
+    }
+    
+    /**
+     * returns the sum of the items, 0 for an empty vector. Integral items
+     * are summed up as 64 bit integers, floating point items as double.
+     * Vectors of numbers are summed using SSE2 or AVX2 depending on the cpu.
+     */
+    typename Simd::SumOf<Item>::Type sum() const {
+      return this->view().sum();
+    }
+    
+    /**
+     * returns the smallest item, the first one if there are equal ones
+     * @throws VectorAccessException if the vector is empty
+     */
+    Item min() const {
+      return this->view().min();
+    }
+    
+    /**
+     * returns the biggest item, the first one if there are equal ones
+     * @throws VectorAccessException if the vector is empty
+     */
+    Item max() const {
+      return this->view().max();
+    }
+    
+    /**
+     * returns the smallest and the biggest item in one pass
+     * @throws VectorAccessException if the vector is empty
+     */
+    std::pair<Item, Item> minmax() const {
+      return this->view().minmax();
+    }
+    
+    /**
+     * returns the index of the first smallest item or -1 for an empty vector
+     */
+    Index argmin() const {
+      return this->view().argmin();
+    }
+    
+    /**
+     * returns the index of the first biggest item or -1 for an empty vector
+     */
+    Index argmax() const {
+      return this->view().argmax();
+    }
+    
+    /**
+     * returns the arithmetic mean of the items or NaN for an empty vector
+     */
+    double mean() const {
+      return this->view().mean();
+    }
+    
+    /*
+     * returns a full copy of the vector
+     */
+    Vector<Item, Index, Allocator, Bounds> copy() {
+      return slice(0);
+    }
+    
+    /*
+     * returns a slice from the starting of the vector to the end
+     * @param start the start index from where to slice from. If you want to
+     *              slice from the beginning just pass 0. The index may be
+     *              negative and will be converted in Nth item before the end.
+     * @return a new vector that contains all slice items
+     */
+    Vector<Item, Index, Allocator, Bounds> slice(const int start) {
+      return slice(start, this->elementsSize - start);
+    }
+    
+    /**
+     * returns a slice from the start index with a max count of entrys of 
+     * size
+     * @param start the start index from where to slice from. If you want to
+     *              slice from the beginning just pass 0. The index may be
+     *              negative and will be converted in Nth item before the end.
+     * @param size the number of elements that should be in the new vector
+     * @return a new vector that contains all slice items
+     */
+    Vector<Item, Index, Allocator, Bounds> slice(const Index start, const Index size) {
+      Vector<Item, Index, Allocator, Bounds> newSlice(size, this->allocator);
+      newSlice.copyFrom(this, start, size);
+      return newSlice;
+    }
+    
+    /**
+     * returns a view on all elements of the vector. The view doesn't copy
+     * the elements and is only valid until the vector is changed in size.
+     */
+    VectorView<Item, Index> view() const {
+      return VectorView<Item, Index>(this->elements, this->elementsSize);
+    }
+    
+    /**
+     * returns a pointer to the first element, which is a random access
+     * iterator for range based for loops and the standard algorithms. The
+     * iterators are valid until the vector is changed in size.
+     */
+    Item *begin() {
+      return this->elements;
+    }
+    
+    const Item *begin() const {
+      return this->elements;
+    }
+    
+    /**
+     * returns a pointer behind the last element
+     */
+    Item *end() {
+      return this->elements + this->elementsSize;
+    }
+    
+    const Item *end() const {
+      return this->elements + this->elementsSize;
+    }
+    
+    /**
+     * writes the items in the binary format to the file descriptor, see
+     * VectorView::writeTo
+     */
+    void writeTo(int fd) const {
+      this->view().writeTo(fd);
+    }
+    
+    /**
+     * reads a vector that was written by writeTo and adds its items to the
+     * end of the vector. The items are read directly into the elements,
+     * they are only added if the checksum matches. The elements grow with
+     * the items that were read (the chunks double, starting with 64 KB), so
+     * a damaged count in the header can't allocate much more memory than
+     * the file has. Use a VectorReader to read big files with bounded
+     * memory.
+     * @param fd the file descriptor to read from
+     * @return self (the current vector) to enable chaining
+     * @throws SerializationException if the read fails or the data is no
+     *                                vector of these items
+     * @throws std::bad_alloc if the elements can't grow
+     */
+    Vector<Item, Index, Allocator, Bounds> &readFrom(int fd) {
+      static_assert(std::is_trivially_copyable<Item>::value,
+                    "only trivially copyable items can be read");
+      Serialization::Header header = Serialization::readHeader(fd, sizeof(Item));
+      if (header.count > (uint64_t)std::numeric_limits<Index>::max() - this->elementsSize) {
+        throw SerializationException("has too many items");
+      }
+      
+      Index count = (Index)header.count;
+      Index done = 0;
+      Index chunk = (Index)std::max<size_t>(1, Serialization::CHUNK_BYTES / sizeof(Item));
+      Serialization::Checksum checksum;
+      while (done < count) {
+        Index size = std::min(count - done, std::max(chunk, done));
+        this->ensureSpace(this->elementsSize + done + size);
+        Item *items = this->elements + this->elementsSize + done;
+        size_t bytes = (size_t)size * sizeof(Item);
+        if (Serialization::readAll(fd, items, bytes) != bytes) {
+          throw SerializationException("ends before the last item");
+        }
+        checksum.update(items, bytes);
+        done += size;
+      }
+      
+      if (checksum.value() != header.checksum) {
+        throw SerializationException("has a wrong checksum");
+      }
+      this->elementsSize += count;
+      this->countMove((size_t)count * sizeof(Item));
+      this->countSize((size_t)this->elementsSize * sizeof(Item));
+      return *(this);
+    }
+    
+    /**
+     * returns a view from the starting index to the end of the vector
+     * @param start the start index from where to view from. The index may be
+     *              negative and will be converted in Nth item before the end.
+     */
+    VectorView<Item, Index> view(const Index start) const {
+      return this->view().slice(start);
+    }
+    
+    /**
+     * returns a view from the start index with a max count of entrys of 
+     * size. The same boundary checks as for slice apply, but the elements
+     * are not copied.
+     * @param start the start index from where to view from. The index may be
+     *              negative and will be converted in Nth item before the end.
+     * @param size the number of elements that should be in the view
+     */
+    VectorView<Item, Index> view(const Index start, const Index size) const {
+      return this->view().slice(start, size);
+    }
+    
+    /**
+     * returns a lazy pipe over the items of the vector. The operations of
+     * the pipe are fused into one pass over the items, without intermediate
+     * vectors:
+     *   vector.pipe().filter(predicate).map(mapping).reduce(initial, operation)
+     * The pipe is only valid until the vector is changed in size.
+     */
+    Pipe<PipeSource<Item>, Index> pipe() const {
+      return this->view().pipe();
+    }
+    
+    /**
+     * map all values of the vector using the passed function
+     * @param fn the function that will be used to manipulate the current vector 
+     */
+    void map(mappingFunction fn) {
+      this->template map<mappingFunction>(fn);
+    }
+    
+    /**
+     * map all values of the vector using the passed callable (e.g. a lambda
+     * or function object), which can be inlined by the compiler.
+     * @param fn the callable that takes an item and returns the new item
+     */
+    template <typename Mapping>
+    void map(Mapping fn) {
+      Item *elements = this->elements;
       for (Index i = 0; i < this->elementsSize; ++i) {
-        if (this->elements[i] == item) {
-          found = i;
+        elements[i] = fn(elements[i]);
+      }
+    }
+    
+    /**
+     * map all values of the vector like map() using the threads of the
+     * shared pool. The vector is split in blocks that fit into the cache,
+     * small vectors are mapped on the calling thread.
+     * @param fn the callable that takes an item and returns the new item, it
+     *           is called from multiple threads at the same time
+     */
+    template <typename Mapping>
+    void parallelMap(Mapping fn) {
+      this->parallelMap(ThreadPool::shared(), fn);
+    }
+    
+    /**
+     * map all values of the vector using the threads of the passed pool
+     * @param pool the pool whose threads will be used
+     * @param fn the callable that takes an item and returns the new item
+     */
+    template <typename Mapping>
+    void parallelMap(ThreadPool &pool, Mapping fn) {
+      Item *elements = this->elements;
+      this->parallelBlocks(pool, [elements, &fn](Index begin, Index end, Index) {
+        for (Index i = begin; i < end; ++i) {
+          elements[i] = fn(elements[i]);
+        }
+      });
+    }
+    
+    /**
+     * calls the callable for every item of the vector using the threads of
+     * the shared pool. The order of the calls is undefined.
+     * @param fn the callable that takes an item, it is called from multiple
+     *           threads at the same time
+     */
+    template <typename Function>
+    void parallelForEach(Function fn) {
+      this->parallelForEach(ThreadPool::shared(), fn);
+    }
+    
+    /**
+     * calls the callable for every item using the threads of the passed pool
+     * @param pool the pool whose threads will be used
+     * @param fn the callable that takes an item
+     */
+    template <typename Function>
+    void parallelForEach(ThreadPool &pool, Function fn) {
+      Item *elements = this->elements;
+      this->parallelBlocks(pool, [elements, &fn](Index begin, Index end, Index) {
+        for (Index i = begin; i < end; ++i) {
+          fn(elements[i]);
+        }
+      });
+    }
+    
+    /**
+     * combines all items of the vector using the threads of the shared pool.
+     * Every block is folded on its own, starting with a copy of identity,
+     * the results of the blocks are then combined in their order. For an
+     * associative operation the result is the same as folding the items
+     * from first to last. The blocks don't depend on the number of threads,
+     * so the result is always the same.
+     * @param identity the result for an empty vector, which has to leave
+     *                 every result unchanged (like 0 for a sum), as every
+     *                 block starts with it
+     * @param operation the callable that folds an item into a result and
+     *                  combines the results of the blocks, so it has to
+     *                  accept (Result, Item) and (Result, Result)
+     * @return the fold of all items
+     */
+    template <typename Result, typename Operation>
+    Result parallelReduce(Result identity, Operation operation) {
+      return this->parallelReduce(ThreadPool::shared(), identity, operation, operation);
+    }
+    
+    /**
+     * combines all items of the vector using the threads of the passed pool
+     * @param pool the pool whose threads will be used
+     * @param identity the result for an empty vector and of every block
+     * @param operation the associative callable that folds an item into a
+     *                  result and combines two results
+     */
+    template <typename Result, typename Operation>
+    Result parallelReduce(ThreadPool &pool, Result identity, Operation operation) {
+      return this->parallelReduce(pool, identity, operation, operation);
+    }
+    
+    /**
+     * folds the items of every block with operation and combines the
+     * results of the blocks with combine, for folds whose operation can't
+     * combine two results (like a sum of squares)
+     * @param pool the pool whose threads will be used
+     * @param identity the result for an empty vector and of every block
+     * @param operation the callable that folds an item into a result,
+     *                  operation(Result, Item)
+     * @param combine the associative callable that combines the results of
+     *                two blocks, combine(Result, Result)
+     */
+    template <typename Result, typename Operation, typename Combine>
+    Result parallelReduce(ThreadPool &pool, Result identity, Operation operation,
+                          Combine combine) {
+      if (this->elementsSize == 0) return identity;
+      
+      Vector<Result, Index> results(this->parallelBlockCount());
+      results.fill(identity, this->parallelBlockCount());
+      
+      Item *elements = this->elements;
+      Result *partial = &results[0];
+      this->parallelBlocks(pool, [elements, partial, &operation](Index begin, Index end, 
+                                                                 Index block) {
+        Result result(partial[block]);
+        for (Index i = begin; i < end; ++i) {
+          result = operation(std::move(result), elements[i]);
         }
+        partial[block] = std::move(result);
+      });
+      
+      for (Index i = 0; i < results.size(); ++i) {
+        identity = combine(std::move(identity), results[i]);
       }
-      return found;
+      return identity;
     }
     
-    /*
-     * returns a full copy of the vector
+    /**
+     * reverse all elements in this vector
      */
-    Vector<Item, Index> copy() {
-      return slice(0);
+    void reverse() {
+      for (Index i = 0, j = this->elementsSize - 1; i < this->elementsSize / 2; ++i) {
+        Foundation::swap(this->elements[j--], this->elements[i]);
+      }
     }
     
-    /*
-     * returns a slice from the starting of the vector to the end
-     * @param start the start index from where to slice from. If you want to
-     *              slice from the beginning just pass 0. The index may be
-     *              negative and will be converted in Nth item before the end.
-     * @return a new vector that contains all slice items
+    /**
+     * sort this array using the defaultComperator. This sort uses introsort
+     * (quicksort with heapsort fallback) and is therefore O(N log N) even in
+     * the worst case. Vectors of integral or floating point numbers that are
+     * sorted using the defaultCompare are sorted using a radix sort in O(N).
+     * @param fn the function to use, to compare the elements while sorting
      */
-    Vector<Item, Index> slice(const int start) {
-      return slice(start, this->elementsSize - start);
+    void sort(compareFunction fn = defaultCompare) {
+      if (fn == &defaultCompare<Item> && this->sortRadix()) return;
+      this->template sort<compareFunction>(fn);
     }
     
     /**
-     * returns a slice from the start index with a max count of entrys of 
-     * size
-     * @param start the start index from where to slice from. If you want to
-     *              slice from the beginning just pass 0. The index may be
-     *              negative and will be converted in Nth item before the end.
-     * @param size the number of elements that should be in the new vector
-     * @return a new vector that contains all slice items
+     * sort this array using the passed callable, which can be inlined by the
+     * compiler. The callable is either a compare function that returns < 0, 
+     * 0 or > 0 like defaultCompare, or a less predicate that returns a bool
+     * like std::less. Sorting using std::less uses the radix sort like the 
+     * defaultCompare.
+     * @param compare the callable to compare the elements while sorting
      */
-    Vector<Item, Index> slice(const Index start, const Index size) {
-      Vector<Item, Index> newSlice(size);
-      newSlice.copyFrom(this, start, size);
-      return newSlice;
+    template <typename Compare>
+    void sort(Compare compare) {
+      if (std::is_same<Compare, std::less<Item> >::value && this->sortRadix()) {
+        return;
+      }
+      SortLess<Item, Compare> less(compare);
+#ifdef FOUNDATION_VECTOR_STATS
+      CountedLess<Item, SortLess<Item, Compare> > counted(less);
+      this->introsort(0, this->elementsSize - 1, 
+                      sortDepthLimit(this->elementsSize), counted);
+      this->countComparisons(counted.count);
+#else
+      this->introsort(0, this->elementsSize - 1, 
+                      sortDepthLimit(this->elementsSize), less);
+#endif
     }
     
     /**
-     * map all values of the vector using the passed function
-     * @param fn the function that will be used to manipulate the current vector 
+     * sort this array like sort() but split the partitions across the threads
+     * of the passed pool. The partitions are the same as the serial sort 
+     * creates, so the result is identical to sort() using the same compare
+     * function. Small vectors are sorted serially. Numbers sorted using the
+     * defaultCompare take the radix sort like sort(), which orders -0.0
+     * before 0.0 and NaNs by their sign, unlike the comparison sort.
+     * @param pool the pool whose threads will be used for sorting
+     * @param fn the function to use, to compare the elements while sorting
      */
-    void map(mappingFunction fn) {
-      for (Index i = 0; i < this->elementsSize; ++i) {
-        this->elements[i] = fn(this->elements[i]);
-      }
+    void sortParallel(ThreadPool &pool, compareFunction fn = defaultCompare) {
+      if (fn == &defaultCompare<Item> && this->sortRadix()) return;
+      this->template sortParallel<compareFunction>(pool, fn);
     }
     
     /**
-     * reverse all elements in this vector
+     * sort this array like sortParallel() using the passed callable. The 
+     * callable is called from multiple threads at the same time.
+     * @param pool the pool whose threads will be used for sorting
+     * @param compare the callable to compare the elements while sorting
      */
-    void reverse() {
-      for (Index i = 0, j = this->elementsSize - 1; i < this->elementsSize / 2; ++i) {
-        swap(this->elements[j--], this->elements[i]);
+    template <typename Compare>
+    void sortParallel(ThreadPool &pool, Compare compare) {
+      if (std::is_same<Compare, std::less<Item> >::value && this->sortRadix()) {
+        return;
       }
+      SortLess<Item, Compare> less(compare);
+      TaskGroup group;
+      try {
+        this->introsortParallel(0, this->elementsSize - 1, 
+                                sortDepthLimit(this->elementsSize), less, 
+                                pool, group);
+      } catch (...) {
+        // the tasks use the group and the predicate on this stack
+        pool.wait(group);
+        throw;
+      }
+      pool.wait(group);
     }
     
     /**
-     * sort this array using the defaultComperator. This sort using quicksort
-     * with no worst case O(N^2) protection.
+     * sort this array like sort() using the passed number of threads.
+     * @param threads the number of threads to use, 0 uses the shared pool of
+     *                the library which keeps all cores busy
      * @param fn the function to use, to compare the elements while sorting
      */
-    void sort(compareFunction fn = defaultCompare) {
-      this->quicksort(0, this->elementsSize - 1, fn);
+    void sortParallel(unsigned threads = 0, compareFunction fn = defaultCompare) {
+      if (threads == 0) {
+        this->sortParallel(ThreadPool::shared(), fn);
+      } else if (threads == 1 || this->elementsSize < SORT_PARALLEL_THRESHOLD) {
+        this->sort(fn);
+      } else {
+        ThreadPool pool(threads - 1);
+        this->sortParallel(pool, fn);
+      }
     }
     
     /**
@@ -287,25 +1441,62 @@ namespace Foundation {
      * index was passed.
      * @return the element that was found at the given index
      */
-    Item operator[](const Index index) const {
-      return *this->at(index);
+    const Item &operator[](const Index index) const {
+      return this->at(index);
     }
     
     /*
      * removes all items from the vector that are equal to item. This
-     * will traverse the whole Vector in O(N). 
+     * will traverse the whole Vector in O(N) and moves every remaining item
+     * at most once. 
      * @param the element that will be used for searching
      * @return the count of deleted items, 0 when no item was removed 
      */
     Index remove(const Item &item) {
-      Index removed = 0;
-      for (Index i = 0; i < this->elementsSize; ++i) {
-        if (this->elements[i] == item) {
-          this->removeAt(i);
-          removed++;
-        }
+      Index first = this->index(item);
+      if (first < 0) return 0;
+      return this->compact(first, [&item](const Item &element) {
+        return element == item;
+      });
+    }
+    
+    /*
+     * removes all items from the vector for which the predicate returns
+     * true. The order of the remaining items is kept. O(N)
+     * @param predicate the callable that takes an item and returns true if
+     *                  the item should be removed
+     * @return the count of deleted items, 0 when no item was removed 
+     */
+    template <typename Predicate>
+    Index removeIf(Predicate predicate) {
+      return this->compact(0, predicate);
+    }
+    
+    /*
+     * removes all items from the vector that are equal to one of the passed
+     * items. Big lists of items are sorted and searched using binary search,
+     * so this is O(N log M) for M items.
+     * @param items the items to remove
+     * @return the count of deleted items, 0 when no item was removed 
+     */
+    Index removeAll(const VectorView<Item, Index> &items) {
+      if (items.size() <= REMOVE_SEARCH_THRESHOLD) {
+        return this->compact(0, [&items](const Item &element) {
+          return items.contains(element);
+        });
       }
-      return removed;
+      
+      Vector<Item, Index> lookup = items.copy();
+      lookup.sort();
+      VectorView<Item, Index> sorted = lookup.view();
+      return this->compact(0, [&sorted](const Item &element) {
+        return std::binary_search(sorted.begin(), sorted.end(), element);
+      });
+    }
+    
+    template <typename OtherAllocator, typename OtherBounds>
+    Index removeAll(const Vector<Item, Index, OtherAllocator, OtherBounds> &items) {
+      return this->removeAll(items.view());
     }
     
     /**
@@ -317,38 +1508,71 @@ namespace Foundation {
     Item removeAt(Index index) {
       index = this->indexFor(index);
       // save value
-      Item item = this->elements[index];
-      // move whole array over
-      memmove(&this->elements[index], &this->elements[index + 1],
-              (size_t)(sizeof(Item) * (this->elementsSize - index - 1)));
+      Item item = std::move(this->elements[index]);
+      // move whole array over, this is a memmove for trivial items
+      std::move(this->elements + index + 1, this->elements + this->elementsSize,
+                this->elements + index);
+      this->countMove((size_t)(this->elementsSize - index - 1) * sizeof(Item));
+      this->destroy(this->elementsSize - 1, this->elementsSize);
       this->elementsSize--;
       return item;
     }
     
+    /**
+     * removes size elements starting at the passed index. The elements
+     * behind the range are moved only once. The same boundary checks as for
+     * slice apply.
+     * @param start the index of the first element to remove, may be negative
+     * @param size the number of elements to remove
+     */
+    void removeRange(const Index start, const Index size) {
+      if (size == 0) return;
+      Index begin = this->indexFor(start);
+      Index end = this->indexFor(start + size - 1);
+      if (end < begin) {
+        throw VectorAccessException<Item, Index>(this->elementsSize, end);
+      }
+      std::move(this->elements + end + 1, this->elements + this->elementsSize,
+                this->elements + begin);
+      this->countMove((size_t)(this->elementsSize - end - 1) * sizeof(Item));
+      this->destroy(this->elementsSize - size, this->elementsSize);
+      this->elementsSize -= size;
+    }
+    
     /**
      * returns a string representation of vector
      */
     std::string inspect() const {
-      std::ostringstream details;
-      details << "<Foundation::Vector#" << this << " size:" << this->size()
-              << " values:" << this->toString() << ">";
-      return details.str();
+      std::string details;
+      details.reserve(64 + Format::estimate<Item>(this->elementsSize));
+      Format::StringSink sink(details);
+      Format::details(sink, "Foundation::Vector", this, this->elements,
+                      (size_t)this->elementsSize);
+      return details;
     }
     
     /**
      * returns a string representation of the values of the vector
      */
     std::string toString() const {
-      std::ostringstream values;
-      values << "{";
-      for (Index i = 0; i < this->elementsSize; ++i) {
-        values << this->elements[i];
-        if (i != this->elementsSize - 1) {
-          values << ", ";
-        }
-      }
-      values << "}";
-      return values.str();
+      return VectorView<Item, Index>(this->elements, this->elementsSize).toString();
+    }
+    
+    /**
+     * writes the string representation of the values to the sink, see
+     * VectorView::format
+     */
+    template <typename Sink>
+    void format(Sink &sink) const {
+      this->view().format(sink);
+    }
+    
+    /**
+     * writes the string representation of the values to the file
+     * descriptor, see VectorView::printTo
+     */
+    void printTo(int fd) const {
+      this->view().printTo(fd);
     }
     
     /**
@@ -359,57 +1583,414 @@ namespace Foundation {
      */
     void clear() {
       // free old data
-      if (this->elements != NULL) free(this->elements);
+      if (this->elements != NULL) {
+        this->destroy(0, this->elementsSize);
+        this->deallocateElements(this->bytes());
+      }
       
       // reset usage
       this->elementsSize = 0;
       
       // we create a array with pointers to move around
-      this->elements = (Item *)malloc(this->bytes());
+      this->elements = this->allocateElements();
     }
-    
+  
   protected:
     
     /**
-     * implements a quicksort on the vector. The comparison can be overwritten
-     * using a compare function fn.
+     * implements an introsort on the vector. The comparison can be overwritten
+     * using the less predicate. The partitions are split using quicksort
+     * until they are small enough for an insertion sort. If the recursion
+     * gets too deep (bad pivots) the partition is finished using heapsort,
+     * which keeps up the O(N log N) behaviour in the worst case.
      * @param left the start of the partition, on first call 0
      * @param right the end of the partition, on start usually (size - 1)
-     * @param fn the function that will be used to compare
+     * @param depth the number of partition steps left before heapsort is used
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
      */
-    void quicksort(Index left, Index right, compareFunction fn) {
-      if (left < right) {
-        Index partition = quicksortPartition(left, right, fn);
-        quicksort(left, partition - 1, fn);
-        quicksort(partition + 1, right, fn);
+    template <typename Less>
+    void introsort(Index left, Index right, Index depth, Less &less) {
+      while (right - left >= SORT_INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+          this->heapsort(left, right, less);
+          return;
+        }
+        
+        this->choosePivot(left, right, less);
+        
+        // the element before the partition is smaller or equal to all 
+        // elements in the partition. If it equals the pivot, there is a run
+        // of equal keys which can be put aside in one pass.
+        if (left > 0 && !less(this->elements[left - 1], this->elements[left])) {
+          left = this->introsortPartitionEqual(left, right, less) + 1;
+          continue;
+        }
+        
+        Index partition = this->introsortPartition(left, right, less);
+        
+        // recurse into the smaller half and loop over the bigger one to
+        // limit the stack usage to O(log N)
+        if (partition - left < right - partition) {
+          this->introsort(left, partition - 1, depth, less);
+          left = partition + 1;
+        } else {
+          this->introsort(partition + 1, right, depth, less);
+          right = partition - 1;
+        }
       }
+      this->insertionSort(left, right, less);
     }
     
     /**
-     * returns the index to partition by 
-     * WARNING: has no protection against the worst case O(N^2) behaviour
-     * of quicksort. Maybe i implement introsort which protects you from this
-     * and keep up the O(NlogN= behaviour of the algorithm.
-     * @param left the start of the partition
+     * implements the introsort like introsort() but submits the smaller half
+     * of every big partition as a task to the pool. Small partitions are
+     * sorted using the serial introsort.
+     * @param left the start of the partition, on first call 0
+     * @param right the end of the partition, on start usually (size - 1)
+     * @param depth the number of partition steps left before heapsort is used
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     * @param pool the pool that will run the tasks
+     * @param group the group that the tasks will be added to
+     */
+    template <typename Less>
+    void introsortParallel(Index left, Index right, Index depth, 
+                           Less &less, ThreadPool &pool, 
+                           TaskGroup &group) {
+      while (right - left >= SORT_PARALLEL_THRESHOLD) {
+        if (depth-- == 0) {
+          this->heapsort(left, right, less);
+          return;
+        }
+        
+        this->choosePivot(left, right, less);
+        
+        if (left > 0 && !less(this->elements[left - 1], this->elements[left])) {
+          left = this->introsortPartitionEqual(left, right, less) + 1;
+          continue;
+        }
+        
+        Index partition = this->introsortPartition(left, right, less);
+        Index taskLeft, taskRight;
+        
+        if (partition - left < right - partition) {
+          taskLeft = left;
+          taskRight = partition - 1;
+          left = partition + 1;
+        } else {
+          taskLeft = partition + 1;
+          taskRight = right;
+          right = partition - 1;
+        }
+        
+        pool.submit(group, [this, taskLeft, taskRight, depth, &less, &pool, &group] {
+          this->introsortParallel(taskLeft, taskRight, depth, less, pool, group);
+        });
+      }
+      this->introsort(left, right, depth, less);
+    }
+    
+    /**
+     * partitions the elements around the pivot (which is expected to be at 
+     * left). Equal elements stop both scans so that runs of equal keys will
+     * be split in the middle instead of degenerating.
+     * @param left the start of the partition (holds the pivot)
      * @param right the end of the partition
-     * @param fn the function that will be used to compare
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     * @return the final index of the pivot
      */
-    Index quicksortPartition(Index left, Index right, compareFunction fn) {
+    template <typename Less>
+    Index introsortPartition(Index left, Index right, Less &less) {
+      Item pivot = this->elements[left];
       Index i = left;
-      Index j = right - 1;
-      Item pivot = this->elements[right];  // stupid pivot search
+      Index j = right + 1;
+      
+      for (;;) {
+        while (less(this->elements[++i], pivot)) {
+          if (i == right) break;
+        }
+        // the pivot at left stops this scan
+        while (less(pivot, this->elements[--j]));
+        if (i >= j) break;
+        Foundation::swap(this->elements[i], this->elements[j]);
+      }
+      
+      Foundation::swap(this->elements[left], this->elements[j]);
+      return j;
+    }
+    
+    /**
+     * moves all elements that are equal to the pivot (at left) to the
+     * beginning of the partition. All elements of the partition have to be
+     * greater or equal to the pivot.
+     * @param left the start of the partition (holds the pivot)
+     * @param right the end of the partition
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     * @return the index of the last element that is equal to the pivot
+     */
+    template <typename Less>
+    Index introsortPartitionEqual(Index left, Index right, Less &less) {
+      Item pivot = this->elements[left];
+      Index equal = left;
+      
+      for (Index i = left + 1; i <= right; ++i) {
+        if (!less(pivot, this->elements[i])) {
+          Foundation::swap(this->elements[++equal], this->elements[i]);
+        }
+      }
+      
+      return equal;
+    }
+    
+    /**
+     * searches a good pivot and moves it to the left of the partition. Uses
+     * the median of three and for big partitions the ninther (median of the
+     * medians of three). The samples are spread over the partition so that
+     * patterns like organ pipes don't lead to bad pivots.
+     * @param left the start of the partition
+     * @param right the end of the partition
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     */
+    template <typename Less>
+    void choosePivot(Index left, Index right, Less &less) {
+      Index middle = left + (right - left) / 2;
+      Index quarter = (right - left) / 4;
+      
+      if (right - left >= SORT_NINTHER_THRESHOLD) {
+        Index eighth = quarter / 2;
+        this->sortThree(left, left + eighth, left + quarter, less);
+        this->sortThree(middle - eighth, middle, middle + eighth, less);
+        this->sortThree(right - quarter, right - eighth, right, less);
+        this->sortThree(left + eighth, middle, right - eighth, less);
+      } else {
+        this->sortThree(left + quarter, middle, right - quarter, less);
+      }
+      Foundation::swap(this->elements[left], this->elements[middle]);
+    }
+    
+    /**
+     * sorts the three elements at the passed indexes in place
+     * @param a the index that will hold the smallest element
+     * @param b the index that will hold the median
+     * @param c the index that will hold the biggest element
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     */
+    template <typename Less>
+    inline void sortThree(Index a, Index b, Index c, Less &less) {
+      if (less(this->elements[b], this->elements[a])) {
+        Foundation::swap(this->elements[a], this->elements[b]);
+      }
+      if (less(this->elements[c], this->elements[b])) {
+        Foundation::swap(this->elements[b], this->elements[c]);
+        if (less(this->elements[b], this->elements[a])) {
+          Foundation::swap(this->elements[a], this->elements[b]);
+        }
+      }
+    }
+    
+    /**
+     * sorts the partition using insertion sort, which is the fastest for
+     * small partitions.
+     * @param left the start of the partition
+     * @param right the end of the partition
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     */
+    template <typename Less>
+    void insertionSort(Index left, Index right, Less &less) {
+      for (Index i = left + 1; i <= right; ++i) {
+        Item item = std::move(this->elements[i]);
+        Index j = i;
+        for (; j > left && less(item, this->elements[j - 1]); --j) {
+          this->elements[j] = std::move(this->elements[j - 1]);
+        }
+        this->elements[j] = std::move(item);
+      }
+    }
+    
+    /**
+     * sorts the partition using heapsort. This is the fallback of introsort
+     * if the quicksort recursion gets too deep.
+     * @param left the start of the partition
+     * @param right the end of the partition
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     */
+    template <typename Less>
+    void heapsort(Index left, Index right, Less &less) {
+      Index size = right - left + 1;
+      for (Index i = size / 2 - 1; i >= 0; --i) {
+        this->heapSiftDown(left, i, size, less);
+      }
+      for (Index i = size - 1; i > 0; --i) {
+        Foundation::swap(this->elements[left], this->elements[left + i]);
+        this->heapSiftDown(left, 0, i, less);
+      }
+    }
+    
+    /**
+     * moves the element at the heap position down, until the heap
+     * property is restored
+     * @param offset the index of the heap root in the vector
+     * @param position the heap position of the element to move down
+     * @param size the number of elements in the heap
+     * @param less the predicate that returns true if the first item belongs
+     *             before the second one
+     */
+    template <typename Less>
+    void heapSiftDown(Index offset, Index position, Index size, Less &less) {
+      Item item = std::move(this->elements[offset + position]);
+      Index child;
+      
+      while ((child = 2 * position + 1) < size) {
+        if (child + 1 < size && 
+            less(this->elements[offset + child], this->elements[offset + child + 1])) {
+          child++;
+        }
+        if (!less(item, this->elements[offset + child])) break;
+        this->elements[offset + position] = std::move(this->elements[offset + child]);
+        position = child;
+      }
+      this->elements[offset + position] = std::move(item);
+    }
+    
+    /**
+     * sorts the vector using a LSD radix sort on the RadixKey of the items.
+     * Every pass distributes the items by one byte of the key into a scratch
+     * buffer. Passes where all items have the same byte are skipped.
+     * @return false if the items can't or shouldn't be radix sorted or the
+     *         scratch buffer couldn't be allocated
+     */
+    bool sortRadix() {
+      if (this->elementsSize < SORT_RADIX_THRESHOLD) return false;
+      return this->sortRadix(std::integral_constant<bool, RadixKey<Item>::enabled>());
+    }
+    
+    bool sortRadix(std::false_type) {
+      return false;
+    }
+    
+    /**
+     * the radix sort itself, which is only instantiated for items with a
+     * RadixKey. The scratch buffer is taken from the allocator of the vector.
+     */
+    bool sortRadix(std::true_type) {
+      typedef typename RadixKey<Item>::Key Key;
+      const int passes = sizeof(Key);
+      size_t counts[passes][256];
       
-      do {
-        while (fn(this->elements[i], pivot) <= 0 && i < right) i++;
-        while (fn(this->elements[j], pivot) >= 0 && j > left) j--;
-        if (i < j) swap(this->elements[i], this->elements[j]);
-      } while (i < j);
+      size_t scratchBytes = sizeof(Item) * this->elementsSize;
+      Item *scratch = (Item *)this->allocator.allocate(scratchBytes);
+      if (scratch == NULL) return false;
       
-      if (fn(this->elements[i], pivot) > 0) {
-        swap(this->elements[i], this->elements[right]);
+      // count all bytes of all passes in one run over the items
+      memset(counts, 0, sizeof(counts));
+      for (Index i = 0; i < this->elementsSize; ++i) {
+        Key key = RadixKey<Item>::of(this->elements[i]);
+        for (int pass = 0; pass < passes; ++pass) {
+          counts[pass][(key >> (pass * 8)) & 0xff]++;
+        }
       }
+      
+      Item *from = this->elements;
+      Item *to = scratch;
+      for (int pass = 0; pass < passes; ++pass) {
+        size_t *count = counts[pass];
+        Key first = RadixKey<Item>::of(from[0]);
+        if (count[(first >> (pass * 8)) & 0xff] == (size_t)this->elementsSize) {
+          continue;
+        }
+        
+        // turn the counts into start offsets
+        size_t offset = 0;
+        for (int byte = 0; byte < 256; ++byte) {
+          size_t current = count[byte];
+          count[byte] = offset;
+          offset += current;
+        }
         
-      return i;
+        for (Index i = 0; i < this->elementsSize; ++i) {
+          Key key = RadixKey<Item>::of(from[i]);
+          to[count[(key >> (pass * 8)) & 0xff]++] = from[i];
+        }
+        Foundation::swap(from, to);
+      }
+      
+      if (from != this->elements) {
+        memcpy(this->elements, from, sizeof(Item) * this->elementsSize);
+      }
+      this->allocator.deallocate(scratch, scratchBytes);
+      return true;
+    }
+    
+    /**
+     * returns the number of items of the blocks of the parallel operations
+     */
+    static Index parallelBlockSize() {
+      return sizeof(Item) < PARALLEL_BLOCK_BYTES ? PARALLEL_BLOCK_BYTES / sizeof(Item) : 1;
+    }
+    
+    /**
+     * returns the number of blocks the vector is split in for the parallel
+     * operations
+     */
+    Index parallelBlockCount() const {
+      return (this->elementsSize + parallelBlockSize() - 1) / parallelBlockSize();
+    }
+    
+    /**
+     * calls the body for every block of the vector. The first block is
+     * processed by the calling thread, all others are submitted to the pool.
+     * Returns after all blocks are done and rethrows the first exception of
+     * the body.
+     * @param pool the pool that will run the blocks
+     * @param body the callable that takes the start and end index of the
+     *             block and the index of the block
+     */
+    template <typename Body>
+    void parallelBlocks(ThreadPool &pool, Body body) {
+      Index blocks = this->parallelBlockCount();
+      Index size = parallelBlockSize();
+      if (blocks <= 1 || pool.size() == 1) {
+        for (Index block = 0; block < blocks; ++block) {
+          body(block * size, std::min(this->elementsSize, (block + 1) * size), block);
+        }
+        return;
+      }
+      
+      TaskGroup group;
+      for (Index block = 1; block < blocks; ++block) {
+        Index begin = block * size;
+        Index end = std::min(this->elementsSize, begin + size);
+        pool.submit(group, [&body, begin, end, block] {
+          body(begin, end, block);
+        });
+      }
+      try {
+        body(0, size, 0);
+      } catch (...) {
+        pool.wait(group);
+        throw;
+      }
+      pool.wait(group);
+    }
+    
+    /**
+     * returns the introsort depth limit for the passed number of elements
+     * which is 2 * log2(size)
+     */
+    static Index sortDepthLimit(Index size) {
+      Index depth = 0;
+      while (size > 1) {
+        size >>= 1;
+        depth++;
+      }
+      return depth * 2;
     }
     
     /**
@@ -422,16 +2003,46 @@ namespace Foundation {
      * @param size the number of elements to copy. This may not exceed the
      *             number of elements that are in the vector.
      */
-    void copyFrom(Vector<Item, Index> *vector, const Index start, const Index size) {
+    void copyFrom(Vector<Item, Index, Allocator, Bounds> *vector, const Index start, const Index size) {
       Index begin = vector->indexFor(start);
       Index end = vector->indexFor(start + size - 1);
       // check if the end and the start are in correct order
       if (end < begin) {
-        throw VectorAccessException<Item, Index>(vector, end);
+        throw VectorAccessException<Item, Index>(vector->elementsSize, end);
       } else {
-        memcpy(this->elements, &(vector->at(begin)), sizeof(Item) * size);
-        this->elementsSize = size;
+        this->construct(&(vector->at(begin)), size);
+      }
+    }
+    
+    /**
+     * removes all items for which the predicate returns true in a single
+     * pass. The remaining items are moved to the front in their order.
+     * @param start the index of the first item that may be removed, all items 
+     *              before are kept
+     * @param predicate the callable that returns true for items to remove
+     * @return the count of deleted items
+     */
+    template <typename Predicate>
+    Index compact(Index start, Predicate predicate) {
+      Item *elements = this->elements;
+      Index size = this->elementsSize;
+      Index i = start;
+      
+      // nothing has to be moved until the first item is removed
+      while (i < size && !predicate(elements[i])) i++;
+      
+      Index kept = i;
+      Index unmoved = i;
+      for (; i < size; ++i) {
+        if (!predicate(elements[i])) {
+          elements[kept++] = std::move(elements[i]);
+        }
       }
+      this->countMove((size_t)(kept - unmoved) * sizeof(Item));
+      
+      this->destroy(kept, size);
+      this->elementsSize = kept;
+      return size - kept;
     }
     
     /**
@@ -444,13 +2055,14 @@ namespace Foundation {
       // translate negative to positive(negatives are starting from the tail of
       // the list) so given a size of 2 and index of -1 means 1 (the last member
       // of the list)
-      if (index < 0) index = this->elementsSize + index;
-      
-      // check if all constraints are met
-      if (index < 0 || index >= this->elementsSize)
-        throw VectorAccessException<Item>(this, index);
-      
-      return index;
+      return Checked::index<Item, Index>(index, this->elementsSize);
+    }
+    
+    /**
+     * calculates the index for the accessors using the bounds check policy
+     */
+    inline Index accessFor(Index index) const {
+      return Bounds::template index<Item, Index>(index, this->elementsSize);
     }
     
     /**
@@ -461,12 +2073,140 @@ namespace Foundation {
     }
     
     /**
-     * resize the array to the given size
+     * resize the array to the given size. Trivial items are moved by the
+     * allocator (realloc), all other items are move constructed into the new
+     * array and destroyed in the old one.
      * @param size the size of the new array (number of elements, not bytes)
+     * @throws std::bad_alloc if the allocator has no memory, the elements
+     *                        stay unchanged then
      */
     void resizeTo(const Index size) {
+      Index oldSize = this->maxSize;
+      size_t oldBytes = this->bytes();
       this->maxSize = size;
-      this->elements = (Item *)realloc(this->elements, this->bytes());
+      this->countReallocation();
+      this->countMove((size_t)this->elementsSize * sizeof(Item));
+      if (TRIVIAL_ITEMS) {
+        this->countFree(oldBytes);
+        this->countAllocation(this->bytes());
+        this->countCapacity(this->bytes());
+        Item *elements = (Item *)this->allocator.reallocate(this->elements, 
+                                                            oldBytes, this->bytes());
+        if (elements == NULL && size > 0) {
+          this->maxSize = oldSize;
+          throw std::bad_alloc();
+        }
+        this->elements = elements;
+        return;
+      }
+      
+      Item *moved = this->allocateElements();
+      if (moved == NULL && size > 0) {
+        this->maxSize = oldSize;
+        throw std::bad_alloc();
+      }
+      for (Index i = 0; i < this->elementsSize; ++i) {
+        new (moved + i) Item(std::move_if_noexcept(this->elements[i]));
+      }
+      this->destroy(0, this->elementsSize);
+      this->deallocateElements(oldBytes);
+      this->elements = moved;
+    }
+    
+    /**
+     * takes the elements and the allocator of the other vector, which is left
+     * without elements. This vector has no elements.
+     */
+    void take(Vector<Item, Index, Allocator, Bounds> &other, std::true_type) {
+      this->allocator = other.allocator;
+      this->elements = other.elements;
+      this->maxSize = other.maxSize;
+      this->elementsSize = other.elementsSize;
+      other.elements = NULL;
+      other.maxSize = 0;
+      other.elementsSize = 0;
+    }
+    
+    /**
+     * moves the items of the other vector into new elements of this vector,
+     * the other vector keeps its (empty) elements
+     */
+    void take(Vector<Item, Index, Allocator, Bounds> &other, std::false_type) {
+      this->maxSize = other.maxSize;
+      this->elements = this->allocateElements();
+      for (Index i = 0; i < other.elementsSize; ++i) {
+        new (this->elements + i) Item(std::move(other.elements[i]));
+      }
+      this->elementsSize = other.elementsSize;
+      other.destroy(0, other.elementsSize);
+      other.elementsSize = 0;
+    }
+    
+    /**
+     * allocates the elements for maxSize items
+     */
+    inline Item *allocateElements() {
+      this->countAllocation(this->bytes());
+      this->countCapacity(this->bytes());
+      return (Item *)this->allocator.allocate(this->bytes());
+    }
+    
+    /**
+     * gives the elements back to the allocator
+     * @param bytes the size of the elements when they were allocated
+     */
+    inline void deallocateElements(size_t bytes) {
+      this->countFree(bytes);
+      this->allocator.deallocate(this->elements, bytes);
+    }
+    
+    /**
+     * doubles the size of the array
+     */
+    void grow() {
+      this->resizeTo(this->maxSize > 0 ? this->maxSize * 2 : 1);
+    }
+    
+    /**
+     * makes sure the array has space for size items. The array grows at 
+     * least to the double size, so that repeated appends stay O(1) amortized.
+     * @param size the number of items the array has to hold
+     */
+    void ensureSpace(const Index size) {
+      if (size <= this->maxSize) return;
+      this->resizeTo(size > this->maxSize * 2 ? size : this->maxSize * 2);
+    }
+    
+    /**
+     * returns true if the pointer points to an item of the vector
+     */
+    bool owns(const Item *pointer) const {
+      return pointer >= this->elements && pointer < this->elements + this->elementsSize;
+    }
+    
+    /**
+     * copy constructs the items of the array behind the last item of the
+     * vector, which needs to have enough space. This is a memcpy for
+     * trivial items.
+     * @param array the items to copy
+     * @param size the number of items to copy
+     */
+    void construct(const Item *array, const Index size) {
+      std::uninitialized_copy(array, array + size, this->elements + this->elementsSize);
+      this->elementsSize += size;
+      this->countMove((size_t)size * sizeof(Item));
+      this->countSize((size_t)this->elementsSize * sizeof(Item));
+    }
+    
+    /**
+     * calls the destructor of the items in the range [from, to), which does
+     * nothing for trivial items
+     */
+    void destroy(const Index from, const Index to) {
+      if (std::is_trivially_destructible<Item>::value) return;
+      for (Index i = from; i < to; ++i) {
+        this->elements[i].~Item();
+      }
     }
   };
 };
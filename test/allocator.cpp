@@ -0,0 +1,119 @@
+#include <iostream>
+#include "test.h"
+#include "allocator.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testArenaAllocate() {
+  Arena arena(1024);
+  char *first = (char *)arena.allocate(10);
+  char *second = (char *)arena.allocate(10);
+  assertNotEquals((char *)NULL, first);
+  assertEquals(first + Arena::ALIGNMENT, second);
+  assertEquals((size_t)0, (size_t)second % Arena::ALIGNMENT);
+  assertEquals((size_t)32, arena.bytesUsed());
+  
+  // bigger than a block
+  char *big = (char *)arena.allocate(4096);
+  assertNotEquals((char *)NULL, big);
+  memset(big, 1, 4096);
+}
+
+void testArenaLatestAllocation() {
+  Arena arena(1024);
+  arena.allocate(16);
+  char *latest = (char *)arena.allocate(16);
+  
+  // the latest allocation grows in place
+  assertEquals(latest, (char *)arena.reallocate(latest, 16, 64));
+  assertEquals((size_t)80, arena.bytesUsed());
+  
+  // and is given back
+  arena.deallocate(latest, 64);
+  assertEquals((size_t)16, arena.bytesUsed());
+  assertEquals(latest, (char *)arena.allocate(16));
+}
+
+void testArenaReset() {
+  Arena arena(1024);
+  char *first = (char *)arena.allocate(100);
+  for (int i = 0; i < 100; ++i) arena.allocate(100);
+  arena.reset();
+  assertEquals((size_t)0, arena.bytesUsed());
+  
+  // the first block is reused
+  assertEquals(first, (char *)arena.allocate(100));
+}
+
+void testPoolReuse() {
+  Pool pool;
+  void *first = pool.allocate(100);
+  assertEquals((size_t)128, pool.bytesUsed());
+  pool.deallocate(first, 100);
+  assertEquals((size_t)0, pool.bytesUsed());
+  
+  // same size class gets the freed memory
+  assertEquals(first, pool.allocate(120));
+  
+  // reallocating in the same class keeps the memory
+  assertEquals(first, pool.reallocate(first, 120, 128));
+  void *moved = pool.reallocate(first, 128, 1000);
+  assertNotEquals(first, moved);
+  assertEquals(first, pool.allocate(128));
+  
+  // big allocations are not pooled
+  void *big = pool.allocate(Pool::LARGEST + 1);
+  pool.deallocate(big, Pool::LARGEST + 1);
+}
+
+void testVectorWithArena() {
+  Arena arena;
+  {
+    Vector<int, int, ArenaAllocator> vector(4, ArenaAllocator(arena));
+    for (int i = 0; i < 1000; ++i) {
+      vector << i;
+    }
+    assertEquals(1000, vector.size());
+    assertEquals(999, vector.last());
+    assertNotEquals((size_t)0, arena.bytesUsed());
+    
+    Vector<int, int, ArenaAllocator> slice = vector.slice(10, 10);
+    assertEquals(10, slice.first());
+    assertEquals(10, slice.size());
+  }
+  arena.reset();
+  assertEquals((size_t)0, arena.bytesUsed());
+}
+
+void testVectorWithPool() {
+  Pool pool;
+  {
+    Vector<int, int, PoolAllocator> vector(4, PoolAllocator(pool));
+    for (int i = 0; i < 1000; ++i) {
+      vector << i;
+    }
+    assertEquals(1000, vector.size());
+    assertEquals(500, vector[500]);
+    vector.sort(std::greater<int>());
+    assertEquals(999, vector.first());
+    
+    Vector<int> items;
+    items << 1 << 2 << 3;
+    assertEquals(3, vector.removeAll(items));
+  }
+  assertEquals((size_t)0, pool.bytesUsed());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("Allocator", 10);
+  suite << testArenaAllocate;
+  suite << testArenaLatestAllocation;
+  suite << testArenaReset;
+  suite << testPoolReuse;
+  suite << testVectorWithArena;
+  suite << testVectorWithPool;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include "test.h"
+#include "deque.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testPushPop() {
+  Deque<int> deque(4);
+  assertEquals(true, deque.isEmpty());
+  assertEquals(4, deque.capacity());
+  assertThrows(VectorAccessException<int>, deque.popFront());
+  assertThrows(VectorAccessException<int>, deque.popBack());
+  
+  deque.pushBack(2);
+  deque.pushBack(3);
+  deque.pushFront(1);
+  deque.pushFront(0);
+  assertEquals(4, deque.size());
+  assertEquals(4, deque.capacity());
+  assertEquals(string("{0, 1, 2, 3}"), deque.toString());
+  
+  assertEquals(0, deque.popFront());
+  assertEquals(3, deque.popBack());
+  assertEquals(1, deque.first());
+  assertEquals(2, deque.last());
+  assertEquals(1, deque.popFront());
+  assertEquals(2, deque.popFront());
+  assertEquals(true, deque.isEmpty());
+  
+  // a queue that wraps around the ring buffer many times without growing
+  for (int i = 0; i < 100; ++i) {
+    deque << i << i + 1;
+    assertEquals(i, deque.popFront());
+    assertEquals(i + 1, deque.popFront());
+  }
+  assertEquals(4, deque.capacity());
+}
+
+void testGrow() {
+  Deque<int> deque(4);
+  deque << 2 << 3 << 4;
+  deque.pushFront(1);
+  deque.popFront();
+  deque.pushFront(1);
+  
+  // grows while the items wrap around the end of the buffer
+  deque.pushFront(0);
+  assertEquals(8, deque.capacity());
+  deque << 5;
+  for (int i = 0; i < 6; ++i) assertEquals(i, deque[i]);
+  
+  for (int i = 6; i < 1000; ++i) deque << i;
+  for (int i = -1; i > -20; --i) deque.pushFront(i);
+  assertEquals(1024, deque.capacity());
+  for (int i = 0; i < deque.size(); ++i) assertEquals(i - 19, deque[i]);
+  
+  // copies have their own items
+  Deque<int> copy = deque;
+  copy[0] = 42;
+  assertEquals(-19, deque[0]);
+  assertEquals(deque.size(), copy.size());
+  assertEquals(999, copy.last());
+  deque = copy;
+  assertEquals(42, deque.first());
+}
+
+void testAccess() {
+  Deque<int> deque(4);
+  deque << 3 << 4;
+  deque.pushFront(2);
+  deque.pushFront(1);
+  deque[1] = 20;
+  assertEquals(20, deque.at(1));
+  assertEquals(4, deque[-1]);
+  assertEquals(1, deque[-4]);
+  assertThrows(VectorAccessException<int>, deque[4]);
+  assertThrows(VectorAccessException<int>, deque.at(-5));
+  
+  assertEquals(1, deque.index(20));
+  assertEquals(3, deque.index(4));
+  assertEquals(3, deque.lastIndex(4));
+  assertEquals(-1, deque.index(5));
+  assertEquals(true, deque.contains(1));
+  
+  // the views of the wrapped items
+  pair<VectorView<int>, VectorView<int> > views = deque.views();
+  assertEquals(2, views.first.size());
+  assertEquals(2, views.second.size());
+  assertEquals(3, views.second.first());
+  
+  // slices are copied across the end of the buffer
+  assertEquals(string("{20, 3}"), deque.slice(1, 2).toString());
+  assertEquals(string("{3, 4}"), deque.slice(-2).toString());
+  assertEquals(string("{1, 20, 3, 4}"), deque.slice(0).toString());
+  assertThrows(VectorAccessException<int>, deque.slice(2, 3));
+  
+  ostringstream details;
+  details << "<Foundation::Deque#" << &deque << " size:4 values:{1, 20, 3, 4}>";
+  assertEquals(details.str(), deque.inspect());
+}
+
+void testRemoveAt() {
+  Deque<int> deque(8);
+  for (int i = 0; i < 8; ++i) deque << i;
+  deque.popFront();
+  deque.popFront();
+  deque << 8 << 9;
+  
+  // removes from the front half and the back half
+  assertEquals(3, deque.removeAt(1));
+  assertEquals(8, deque.removeAt(-2));
+  assertEquals(string("{2, 4, 5, 6, 7, 9}"), deque.toString());
+  assertEquals(2, deque.removeAt(0));
+  assertEquals(9, deque.removeAt(-1));
+  assertEquals(string("{4, 5, 6, 7}"), deque.toString());
+  deque.clear();
+  assertEquals(true, deque.isEmpty());
+  assertEquals(string("{}"), deque.toString());
+}
+
+void testObjects() {
+  Deque<string> strings(2);
+  for (int i = 0; i < 50; ++i) {
+    strings.pushFront(string(40, 'a' + i % 26));
+    strings << string(40, 'z');
+  }
+  assertEquals(100, strings.size());
+  assertEquals(string(40, 'x'), strings.first());
+  assertEquals(string(40, 'x'), strings.popFront());
+  assertEquals(string(40, 'w'), strings.first());
+  assertEquals(string(40, 'z'), strings.popBack());
+  
+  // the own items are copied before the full deque grows
+  Deque<string> own(2);
+  own << string(40, 'a') << string(40, 'b');
+  own.pushBack(own.first());
+  assertEquals(string(40, 'a'), own.last());
+  own << string(40, 'c');
+  own.pushFront(own.last());
+  assertEquals(string(40, 'c'), own.first());
+  own.pushBack(std::move(own[1]));
+  assertEquals(string(40, 'a'), own.last());
+  own << string(40, 'd') << string(40, 'e');
+  own.pushFront(std::move(own[-1]));
+  assertEquals(string(40, 'e'), own.first());
+  assertEquals(16, own.capacity());
+  
+  // items are moved and destroyed
+  shared_ptr<int> shared(new int(1));
+  {
+    Deque<shared_ptr<int> > pointers(2);
+    for (int i = 0; i < 10; ++i) pointers.pushFront(shared);
+    assertEquals(11L, shared.use_count());
+    pointers.popBack();
+    pointers.removeAt(3);
+    assertEquals(9L, shared.use_count());
+  }
+  assertEquals(1L, shared.use_count());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("Deque", 10);
+  suite << testPushPop;
+  suite << testGrow;
+  suite << testAccess;
+  suite << testRemoveAt;
+  suite << testObjects;
+  suite.run();
+  return 0;
+}
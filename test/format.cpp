@@ -0,0 +1,114 @@
+#include <iostream>
+#include <limits>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <unistd.h>
+#include "test.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+/*
+ * returns the text a stream writes for the items
+ */
+template <typename Item>
+string streamed(const Vector<Item> &vector) {
+  ostringstream values;
+  values << "{";
+  for (int i = 0; i < vector.size(); ++i) {
+    if (i > 0) values << ", ";
+    values << vector.view().at(i);
+  }
+  values << "}";
+  return values.str();
+}
+
+template <typename Item>
+void checkFormat(const Item *items, int size) {
+  Vector<Item> vector;
+  vector.append(items, size);
+  assertEquals(streamed(vector), vector.toString());
+  
+  ostringstream details;
+  details << "<Foundation::Vector#" << &vector << " size:" << size
+          << " values:" << streamed(vector) << ">";
+  assertEquals(details.str(), vector.inspect());
+}
+
+void testNumbers() {
+  int ints[] = { 0, -1, 42, numeric_limits<int>::max(), numeric_limits<int>::min() };
+  checkFormat(ints, 5);
+  checkFormat(ints, 0);
+  unsigned long longs[] = { 0, 7, numeric_limits<unsigned long>::max() };
+  checkFormat(longs, 3);
+  short shorts[] = { -32768, 32767 };
+  checkFormat(shorts, 2);
+  
+  // floating point numbers are written like %g with 6 digits
+  double doubles[] = { 0.0, -0.0, 0.1, 1.0 / 3, 1e100, 1e-5, 123456.7, 1234567.0,
+                       100000, 2.5e15, NAN, INFINITY, -INFINITY, 1e-300 };
+  checkFormat(doubles, 14);
+  float floats[] = { 0.1f, 1e30f, 16777216.0f, numeric_limits<float>::max() };
+  checkFormat(floats, 4);
+  
+  // more numbers than fit into the buffer at once
+  Vector<long> many;
+  for (long i = 0; i < 10000; ++i) many << i * 7919 - 5000000;
+  assertEquals(streamed(many), many.toString());
+}
+
+void testOtherItems() {
+  // chars, bools and strings are still written by a stream
+  char chars[] = { 'a', 'b' };
+  checkFormat(chars, 2);
+  bool bools[] = { true, false };
+  checkFormat(bools, 2);
+  string strings[] = { "x", "yy" };
+  checkFormat(strings, 2);
+}
+
+/*
+ * collects the pieces passed to it
+ */
+struct PiecesSink {
+  string text;
+  int pieces;
+  
+  void append(const char *text, size_t size) {
+    this->text.append(text, size);
+    this->pieces++;
+  }
+};
+
+void testSinks() {
+  Vector<int> vector;
+  for (int i = 0; i < 5000; ++i) vector << i;
+  
+  PiecesSink sink = { "", 0 };
+  vector.format(sink);
+  assertEquals(vector.toString(), sink.text);
+  assertEquals(true, sink.pieces > 1);
+  
+  // the text is written to the file without a string
+  FILE *file = tmpfile();
+  vector.view().slice(0, 3).printTo(fileno(file));
+  vector.printTo(fileno(file));
+  rewind(file);
+  char text[16] = { 0 };
+  assertEquals((size_t)15, fread(text, 1, 15, file));
+  assertEquals(string("{0, 1, 2}{0, 1,"), string(text));
+  fclose(file);
+  
+  assertThrows(SerializationException, vector.printTo(-1));
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("Format", 10);
+  suite << testNumbers;
+  suite << testOtherItems;
+  suite << testSinks;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+#include "test.h"
+#include "indexedvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testIndex() {
+  int numbers[] = { 5, 3, 8, 3, 1, 5, 3 };
+  IndexedVector<int> vector(VectorView<int>(numbers, 7));
+  assertEquals(false, vector.isIndexed());
+  assertEquals((size_t)0, vector.indexBytes());
+  
+  assertEquals(1, vector.index(3));
+  assertEquals(true, vector.isIndexed());
+  assertEquals(true, vector.indexBytes() >= 4 * 2 * sizeof(int));
+  assertEquals(6, vector.lastIndex(3));
+  assertEquals(0, vector.index(5));
+  assertEquals(5, vector.lastIndex(5));
+  assertEquals(2, vector.index(8));
+  assertEquals(2, vector.lastIndex(8));
+  assertEquals(-1, vector.index(4));
+  assertEquals(-1, vector.lastIndex(4));
+  assertEquals(true, vector.contains(1));
+  assertEquals(false, vector.contains(0));
+  assertEquals(3, vector.count(3));
+  
+  IndexedVector<int> empty;
+  assertEquals(-1, empty.index(1));
+  assertEquals(-1, empty.lastIndex(1));
+  
+  // the same results as the linear search for many items
+  srand(42);
+  IndexedVector<int> random;
+  Vector<int> plain;
+  for (int i = 0; i < 5000; ++i) {
+    int item = (rand() % 1000) * 1024;
+    random << item;
+    plain << item;
+  }
+  for (int item = -1024; item < 1001 * 1024; item += 512) {
+    assertEquals(plain.index(item), random.index(item));
+    assertEquals(plain.lastIndex(item), random.lastIndex(item));
+  }
+}
+
+void testAppend() {
+  IndexedVector<string> vector;
+  vector << "a" << "b";
+  assertEquals(1, vector.index("b"));
+  
+  // appended items are added to the built index
+  vector << "c" << "a";
+  assertEquals(true, vector.isIndexed());
+  assertEquals(0, vector.index("a"));
+  assertEquals(3, vector.lastIndex("a"));
+  assertEquals(2, vector.index("c"));
+  
+  string more[] = { "d", "b" };
+  vector.append(VectorView<string>(more, 2));
+  assertEquals(true, vector.isIndexed());
+  assertEquals(4, vector.index("d"));
+  assertEquals(5, vector.lastIndex("b"));
+  assertEquals(string("{a, b, c, a, d, b}"), vector.toString());
+  
+  // the index grows with the items
+  IndexedVector<long> numbers;
+  assertEquals(-1, numbers.index(0));
+  size_t bytes = numbers.indexBytes();
+  for (long i = 0; i < 1000; ++i) numbers << i;
+  assertEquals(true, numbers.indexBytes() > bytes);
+  assertEquals(true, numbers.isIndexed());
+  for (long i = 0; i < 1000; ++i) assertEquals((int)i, numbers.index(i));
+}
+
+void testInvalidate() {
+  int numbers[] = { 4, 2, 7, 2 };
+  IndexedVector<int> vector(VectorView<int>(numbers, 4));
+  assertEquals(1, vector.index(2));
+  
+  vector.removeAt(0);
+  assertEquals(false, vector.isIndexed());
+  assertEquals(0, vector.index(2));
+  assertEquals(2, vector.lastIndex(2));
+  
+  vector.reverse();
+  assertEquals(0, vector.index(2));
+  assertEquals(1, vector.index(7));
+  
+  vector.sort();
+  assertEquals(2, vector.index(7));
+  
+  vector.map([](int item) { return item * 10; });
+  assertEquals(-1, vector.index(7));
+  assertEquals(2, vector.index(70));
+  
+  vector.set(0, 5);
+  assertEquals(0, vector.index(5));
+  assertEquals(1, vector.index(20));
+  
+  assertEquals(1, vector.removeIf([](int item) { return item == 20; }));
+  assertEquals(-1, vector.index(20));
+  assertEquals(1, vector.index(70));
+  
+  vector.clear();
+  assertEquals(-1, vector.index(5));
+  assertThrows(VectorAccessException<int>, vector.first());
+}
+
+void testFloatingPoint() {
+  double numbers[] = { 0.0, NAN, -0.0, 1.5 };
+  IndexedVector<double> vector(VectorView<double>(numbers, 4));
+  Vector<double> plain(numbers, 4);
+  
+  // equal like ==, so -0.0 is 0.0 and NAN is never found
+  assertEquals(plain.index(-0.0), vector.index(-0.0));
+  assertEquals(plain.lastIndex(0.0), vector.lastIndex(0.0));
+  assertEquals(plain.index(NAN), vector.index(NAN));
+  assertEquals(3, vector.index(1.5));
+  
+  ostringstream details;
+  details << "<Foundation::IndexedVector#" << &vector << " size:4 values:{0, nan, -0, 1.5}>";
+  assertEquals(details.str(), vector.inspect());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("IndexedVector", 10);
+  suite << testIndex;
+  suite << testAppend;
+  suite << testInvalidate;
+  suite << testFloatingPoint;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,179 @@
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "test.h"
+#include "mappedvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+static string path(const char *name) {
+  return string("/tmp/test-mappedvector-") + name + "-" + to_string(getpid());
+}
+
+static int openFiles() {
+  int count = 0;
+  DIR *fds = opendir("/proc/self/fd");
+  if (fds == NULL) return 0;
+  while (readdir(fds) != NULL) count++;
+  closedir(fds);
+  return count;
+}
+
+void testMappedPersistence() {
+  string file = path("persistence");
+  unlink(file.c_str());
+  {
+    MappedVector<int> vector(file.c_str());
+    assertEquals(0, vector.size());
+    for (int i = 0; i < 100; ++i) vector << i;
+    assertEquals(100, vector.size());
+  }
+  {
+    MappedVector<int> vector(file.c_str());
+    assertEquals(100, vector.size());
+    assertEquals(0, vector.first());
+    assertEquals(99, vector[-1]);
+    assertEquals(42, vector.at(42));
+    assertEquals(42, vector.index(42));
+    assertEquals(-1, vector.index(100));
+    assertThrows(VectorAccessException<int>, vector[100]);
+    
+    // changes are written to the file
+    vector[0] = -1;
+    vector << 100;
+    vector.sync();
+  }
+  {
+    MappedVector<int> vector(file.c_str());
+    assertEquals(101, vector.size());
+    assertEquals(-1, vector.first());
+    assertEquals(100, vector.last());
+  }
+  unlink(file.c_str());
+}
+
+void testMappedGrowing() {
+  string file = path("growing");
+  unlink(file.c_str());
+  {
+    // grows far beyond the first page, which remaps the file
+    MappedVector<long> vector(file.c_str());
+    vector.advise(MappedFile::SEQUENTIAL);
+    for (long i = 0; i < 100000; ++i) vector << i;
+    assertEquals(100000, vector.size());
+    assertEquals(99999L, vector.last());
+  }
+  {
+    MappedVector<long> vector(file.c_str());
+    vector.advise(MappedFile::RANDOM);
+    assertEquals(100000, vector.size());
+    long sum = 0;
+    for (int i = 0; i < vector.size(); ++i) sum += vector[i];
+    assertEquals(4999950000L, sum);
+    assertEquals(4999950000L, (long)vector.sum());
+  }
+  unlink(file.c_str());
+}
+
+void testMappedViewsAndSlices() {
+  string file = path("views");
+  unlink(file.c_str());
+  MappedVector<int> vector(file.c_str());
+  for (int i = 0; i < 1000; ++i) vector << (i * 7919) % 1000;
+  
+  // views point into the mapping
+  VectorView<int> view = vector.view().slice(10, 5);
+  assertEquals((const void *)(vector.view().begin() + 10), (const void *)view.begin());
+  assertEquals(5, view.size());
+  
+  // slices are copies on the heap that outlive the vector
+  Vector<int, int, MappedAllocator> slice = vector.slice(-10, 10);
+  assertEquals(10, slice.size());
+  assertEquals(vector[-1], slice.last());
+  slice[0] = -1;
+  assertEquals(true, vector[-10] != -1);
+  
+  vector.sort();
+  assertEquals(0, vector.first());
+  assertEquals(999, vector.last());
+  for (int i = 1; i < vector.size(); ++i) assertEquals(true, vector[i - 1] <= vector[i]);
+  unlink(file.c_str());
+}
+
+void testMappedCopies() {
+  string file = path("copies");
+  unlink(file.c_str());
+  Vector<int, int, MappedAllocator> *slice;
+  {
+    MappedVector<int> vector(file.c_str());
+    for (int i = 0; i < 100; ++i) vector << 100 + i;
+    slice = new Vector<int, int, MappedAllocator>(vector.slice(0, 8));
+  }
+  
+  // copies that outlive the vector stay on the heap
+  {
+    Vector<int, int, MappedAllocator> copy(*slice);
+    copy.at(0) = 999;
+    for (int i = 0; i < 1000; ++i) copy << i;
+    Vector<int, int, MappedAllocator> moved(std::move(copy));
+    moved.at(1) = 998;
+    slice->clear();
+    *slice << 42;
+  }
+  delete slice;
+  
+  MappedVector<int> vector(file.c_str());
+  assertEquals(100, vector.size());
+  assertEquals(100, vector.first());
+  assertEquals(199, vector.last());
+  unlink(file.c_str());
+}
+
+void testMappedErrors() {
+  string file = path("errors");
+  unlink(file.c_str());
+  {
+    MappedVector<int> vector(file.c_str());
+    vector << 1;
+  }
+  int files = openFiles();
+  
+  // the file was created for items of another size
+  assertThrows(MappedFileException, MappedVector<long>(file.c_str()));
+  assertThrows(MappedFileException, MappedVector<int>("/nonexistent/vector"));
+  
+  // the file is no vector
+  FILE *other = fopen(file.c_str(), "w");
+  fputs("no vector", other);
+  fclose(other);
+  assertThrows(MappedFileException, MappedVector<int>(file.c_str()));
+  
+  // the file has another version
+  unlink(file.c_str());
+  {
+    MappedVector<int> vector(file.c_str());
+  }
+  uint32_t version = 2;
+  FILE *header = fopen(file.c_str(), "r+");
+  fseek(header, 8, SEEK_SET);
+  fwrite(&version, sizeof(version), 1, header);
+  fclose(header);
+  assertThrows(MappedFileException, MappedVector<int>(file.c_str()));
+  
+  // the files of the failed vectors are closed
+  assertEquals(files, openFiles());
+  unlink(file.c_str());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("MappedVector", 10);
+  suite << testMappedPersistence;
+  suite << testMappedGrowing;
+  suite << testMappedViewsAndSlices;
+  suite << testMappedCopies;
+  suite << testMappedErrors;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <string>
+#include "test.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+bool isEven(const int &value) {
+  return value % 2 == 0;
+}
+
+void testReduce() {
+  Vector<int> vector;
+  for (int i = 1; i <= 10; ++i) vector << i;
+  
+  long sum = vector.pipe().reduce(0L, [](long sum, int value) { return sum + value; });
+  assertEquals(55L, sum);
+  
+  long squares = vector.pipe()
+    .filter(isEven)
+    .map([](int value) { return (long)value * value; })
+    .reduce(0L, [](long sum, long value) { return sum + value; });
+  assertEquals(4L + 16 + 36 + 64 + 100, squares);
+  
+  // the items are reduced from first to last
+  string text = vector.pipe().reduce(string(), [](string text, int value) {
+    return text + (char)('0' + value % 10);
+  });
+  assertEquals(string("1234567890"), text);
+  
+  Vector<int> empty;
+  assertEquals(42, empty.pipe().filter(isEven).reduce(42, [](int a, int b) { return a + b; }));
+}
+
+void testCollect() {
+  Vector<int> vector;
+  for (int i = 0; i < 100; ++i) vector << i;
+  
+  Vector<int> even = vector.pipe().filter(isEven).collect();
+  assertEquals(50, even.size());
+  assertEquals(98, even.last());
+  
+  // the mapping may change the type of the items
+  Vector<string> texts = vector.view(0, 3).pipe()
+    .map([](int value) { return string(value + 1, 'x'); })
+    .collect();
+  assertEquals(string("{x, xx, xxx}"), texts.toString());
+  
+  Vector<double> halves = vector.pipe()
+    .filter([](int value) { return value >= 90; })
+    .map([](int value) { return value / 2.0; })
+    .filter([](double value) { return value != 47.0; })
+    .collect();
+  assertEquals(9, halves.size());
+  assertEquals(45.0, halves.first());
+  assertEquals(49.5, halves.last());
+  
+  // the vector itself is not changed
+  assertEquals(100, vector.size());
+  assertEquals(1, vector[1]);
+}
+
+void testForEachAndCount() {
+  Vector<int> vector;
+  for (int i = 0; i < 10; ++i) vector << i;
+  
+  int calls = 0;
+  int last = -1;
+  vector.pipe().filter(isEven).forEach([&](int value) {
+    calls++;
+    last = value;
+  });
+  assertEquals(5, calls);
+  assertEquals(8, last);
+  
+  assertEquals(3, vector.pipe().filter([](int value) { return value > 6; }).count());
+  assertEquals(10, vector.pipe().map([](int value) { return -value; }).count());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("Pipe", 10);
+  suite << testReduce;
+  suite << testCollect;
+  suite << testForEachAndCount;
+  suite.run();
+  return 0;
+}
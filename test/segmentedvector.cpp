@@ -0,0 +1,128 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include "test.h"
+#include "segmentedvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testAppend() {
+  typedef SegmentedVector<int, int, 4> Segmented;
+  Segmented vector;
+  assertEquals(16, (int)Segmented::CHUNK_SIZE);
+  assertEquals(true, vector.isEmpty());
+  assertEquals(0, vector.capacity());
+  assertThrows(VectorAccessException<int>, vector.first());
+  assertEquals(string("{}"), vector.toString());
+  
+  vector << 0 << 1;
+  assertEquals(16, vector.capacity());
+  for (int i = 2; i < 100; ++i) vector << i;
+  assertEquals(100, vector.size());
+  assertEquals(112, vector.capacity());
+  assertEquals(7, vector.chunkCount());
+  for (int i = 0; i < 100; ++i) assertEquals(i, vector[i]);
+  
+  // bulk appends fill the last chunk before the next one
+  Vector<int> numbers;
+  for (int i = 100; i < 150; ++i) numbers << i;
+  vector.append(numbers.view());
+  assertEquals(150, vector.size());
+  for (int i = 0; i < 150; ++i) assertEquals(i, vector.at(i));
+  assertEquals(16, vector.chunk(0).size());
+  assertEquals(6, vector.chunk(-1).size());
+  assertEquals(144, vector.chunk(-1).first());
+  assertThrows(VectorAccessException<int>, vector.chunk(10));
+  
+  vector.reserve(1000);
+  assertEquals(true, vector.capacity() >= 1000);
+  vector.compact();
+  assertEquals(160, vector.capacity());
+}
+
+void testStableReferences() {
+  SegmentedVector<string, int, 2> vector;
+  vector << "first";
+  string &first = vector.first();
+  string *address = &first;
+  for (int i = 0; i < 1000; ++i) vector.emplace(20, 'x');
+  
+  // no item was moved while growing
+  assertEquals(string("first"), first);
+  assertEquals(address, &vector[0]);
+  string &added = vector.emplace("added");
+  vector << "more";
+  assertEquals(&added, &vector[-2]);
+}
+
+void testAccess() {
+  SegmentedVector<int, int, 2> vector;
+  for (int i = 0; i < 10; ++i) vector << i * 10;
+  assertEquals(90, vector.last());
+  assertEquals(90, vector[-1]);
+  assertEquals(0, vector[-10]);
+  vector[-2] = 85;
+  assertEquals(85, vector.at(8));
+  assertThrows(VectorAccessException<int>, vector[10]);
+  assertThrows(VectorAccessException<int>, vector.at(-11));
+  
+  assertEquals(5, vector.index(50));
+  assertEquals(-1, vector.index(55));
+  vector << 50;
+  assertEquals(10, vector.lastIndex(50));
+  assertEquals(true, vector.contains(85));
+  
+  // slices are copied from several chunks
+  assertEquals(string("{30, 40, 50, 60, 70}"), vector.slice(3, 5).toString());
+  assertEquals(string("{85, 90, 50}"), vector.slice(-3).toString());
+  assertThrows(VectorAccessException<int>, vector.slice(9, 3));
+  assertEquals(string("{0, 10, 20, 30, 40, 50, 60, 70, 85, 90, 50}"), vector.toString());
+  
+  SegmentedVector<int, int, 2> small;
+  small << 1 << 2;
+  ostringstream details;
+  details << "<Foundation::SegmentedVector#" << &small << " size:2 values:{1, 2}>";
+  assertEquals(details.str(), small.inspect());
+}
+
+void testRemove() {
+  SegmentedVector<int, int, 2> vector;
+  for (int i = 0; i < 10; ++i) vector << i;
+  assertEquals(2, vector.removeAt(2));
+  assertEquals(9, vector.removeAt(-1));
+  assertEquals(8, vector.pop());
+  assertEquals(string("{0, 1, 3, 4, 5, 6, 7}"), vector.toString());
+  
+  // copies have their own chunks
+  SegmentedVector<int, int, 2> copy = vector;
+  copy[0] = 42;
+  assertEquals(0, vector[0]);
+  assertEquals(7, copy.size());
+  vector = copy;
+  assertEquals(42, vector.first());
+  
+  vector.clear();
+  assertEquals(true, vector.isEmpty());
+  assertThrows(VectorAccessException<int>, vector.pop());
+  
+  shared_ptr<int> shared(new int(1));
+  {
+    SegmentedVector<shared_ptr<int>, int, 2> pointers;
+    for (int i = 0; i < 10; ++i) pointers << shared;
+    pointers.removeAt(0);
+    pointers.pop();
+    assertEquals(9L, shared.use_count());
+  }
+  assertEquals(1L, shared.use_count());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("SegmentedVector", 10);
+  suite << testAppend;
+  suite << testStableReferences;
+  suite << testAccess;
+  suite << testRemove;
+  suite.run();
+  return 0;
+}
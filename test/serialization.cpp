@@ -0,0 +1,157 @@
+#include <iostream>
+#include <stdio.h>
+#include <unistd.h>
+#include "test.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+/*
+ * returns the descriptor of an empty temporary file
+ */
+static int temporary() {
+  return dup(fileno(tmpfile()));
+}
+
+void testWriteAndRead() {
+  Vector<int> numbers;
+  for (int i = 0; i < 1000; ++i) numbers << i * 3;
+  int fd = temporary();
+  numbers.writeTo(fd);
+  assertEquals((off_t)(sizeof(Serialization::Header) + 1000 * sizeof(int)),
+               lseek(fd, 0, SEEK_CUR));
+  
+  lseek(fd, 0, SEEK_SET);
+  Vector<int> read;
+  read.readFrom(fd);
+  assertEquals(1000, read.size());
+  assertEquals(numbers.toString(), read.toString());
+  
+  // the items are added to the end
+  lseek(fd, 0, SEEK_SET);
+  read.readFrom(fd);
+  assertEquals(2000, read.size());
+  assertEquals(2997, read[-1]);
+  assertEquals(0, read[1000]);
+  close(fd);
+  
+  // empty vectors and views
+  fd = temporary();
+  Vector<double> empty;
+  empty.writeTo(fd);
+  numbers.view().slice(10, 3).writeTo(fd);
+  lseek(fd, 0, SEEK_SET);
+  Vector<double> doubles;
+  doubles.readFrom(fd);
+  assertEquals(0, doubles.size());
+  Vector<int> slice;
+  slice.readFrom(fd);
+  assertEquals(string("{30, 33, 36}"), slice.toString());
+  close(fd);
+}
+
+void testReadErrors() {
+  Vector<int> numbers;
+  for (int i = 0; i < 100; ++i) numbers << i;
+  int fd = temporary();
+  numbers.writeTo(fd);
+  
+  // items of another size
+  lseek(fd, 0, SEEK_SET);
+  Vector<long> longs;
+  assertThrows(SerializationException, longs.readFrom(fd));
+  
+  // a damaged item
+  int damaged = 42;
+  pwrite(fd, &damaged, sizeof(int), sizeof(Serialization::Header) + 7 * sizeof(int));
+  lseek(fd, 0, SEEK_SET);
+  Vector<int> read;
+  assertThrows(SerializationException, read.readFrom(fd));
+  assertEquals(0, read.size());
+  
+  // a truncated file
+  ftruncate(fd, sizeof(Serialization::Header) + 50 * sizeof(int));
+  lseek(fd, 0, SEEK_SET);
+  assertThrows(SerializationException, read.readFrom(fd));
+  assertEquals(0, read.size());
+  
+  // a damaged count doesn't allocate more than the file has
+  Serialization::Header header = Serialization::header(sizeof(int), 1 << 30, 0);
+  ftruncate(fd, 0);
+  pwrite(fd, &header, sizeof(header), 0);
+  pwrite(fd, numbers.view().begin(), 100 * sizeof(int), sizeof(header));
+  lseek(fd, 0, SEEK_SET);
+  assertThrows(SerializationException, read.readFrom(fd));
+  assertEquals(0, read.size());
+  assertEquals(true, read.capacity() < (1 << 20));
+  
+  // no vector at all
+  ftruncate(fd, 0);
+  write(fd, "no vector", 9);
+  lseek(fd, 0, SEEK_SET);
+  assertThrows(SerializationException, read.readFrom(fd));
+  close(fd);
+}
+
+void testChunkedReader() {
+  Vector<long> numbers;
+  for (long i = 0; i < 100000; ++i) numbers << i;
+  int fd = temporary();
+  numbers.writeTo(fd);
+  
+  int chunkSizes[] = { 1, 7, 4096, 100000, 0 };
+  for (int size : chunkSizes) {
+    lseek(fd, 0, SEEK_SET);
+    VectorReader<long> reader(fd, size);
+    assertEquals((uint64_t)100000, reader.size());
+    VectorView<long> chunk;
+    long expected = 0;
+    int chunks = 0;
+    while (reader.next(chunk)) {
+      assertEquals(true, size == 0 || chunk.size() <= size);
+      for (int i = 0; i < chunk.size(); ++i) assertEquals(expected++, chunk[i]);
+      chunks++;
+    }
+    assertEquals(100000L, expected);
+    assertEquals(true, chunks >= 1);
+  }
+  
+  // the checksum is verified after the last chunk
+  long damaged = -1;
+  pwrite(fd, &damaged, sizeof(long), sizeof(Serialization::Header));
+  lseek(fd, 0, SEEK_SET);
+  VectorReader<long> reader(fd, 4096);
+  VectorView<long> chunk;
+  auto readAll = [&]() { while (reader.next(chunk)) {} };
+  assertThrows(SerializationException, readAll());
+  close(fd);
+}
+
+void testChecksum() {
+  // the checksum doesn't depend on how the bytes are passed
+  char bytes[1000];
+  for (int i = 0; i < 1000; ++i) bytes[i] = (char)(i * 31);
+  Serialization::Checksum whole;
+  whole.update(bytes, sizeof(bytes));
+  for (int piece = 1; piece < 100; piece += 13) {
+    Serialization::Checksum pieces;
+    for (int i = 0; i < 1000; i += piece) pieces.update(bytes + i, min(piece, 1000 - i));
+    assertEquals(whole.value(), pieces.value());
+  }
+  
+  Serialization::Checksum other;
+  bytes[500]++;
+  other.update(bytes, sizeof(bytes));
+  assertEquals(true, whole.value() != other.value());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("Serialization", 10);
+  suite << testWriteAndRead;
+  suite << testReadErrors;
+  suite << testChunkedReader;
+  suite << testChecksum;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include "test.h"
+#include "sharedvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testSharedCopies() {
+  Vector<int> numbers;
+  for (int i = 0; i < 100; ++i) numbers << i;
+  SharedVector<int> vector(numbers);
+  assertEquals(false, vector.isShared());
+  assertEquals(100, vector.size());
+  
+  SharedVector<int> copy = vector.copy();
+  assertEquals(true, vector.isShared());
+  assertEquals(true, copy.isShared());
+  assertEquals((const void *)vector.view().begin(), (const void *)copy.view().begin());
+  
+  // reading a const vector doesn't copy
+  const SharedVector<int> &constCopy = copy;
+  assertEquals(42, constCopy[42]);
+  assertEquals(99, constCopy.last());
+  assertEquals(true, copy.isShared());
+  
+  // the first change copies the items
+  copy << 100;
+  assertEquals(false, copy.isShared());
+  assertEquals(false, vector.isShared());
+  assertEquals(101, copy.size());
+  assertEquals(100, vector.size());
+  
+  copy[0] = -1;
+  assertEquals(-1, copy.first());
+  assertEquals(0, vector.first());
+  
+  // a private vector is changed in place
+  const int *items = vector.view().begin();
+  vector[1] = -2;
+  assertEquals((const void *)items, (const void *)vector.view().begin());
+}
+
+void testSharedSlices() {
+  SharedVector<int> vector;
+  for (int i = 0; i < 100; ++i) vector << i;
+  
+  SharedVector<int> slice = vector.slice(10, 20);
+  assertEquals(20, slice.size());
+  assertEquals(10, slice.first());
+  assertEquals(29, slice.last());
+  assertEquals(vector.view().begin() + 10, slice.view().begin());
+  assertEquals(-1, slice.index(5));
+  assertEquals(5, slice.index(15));
+  
+  SharedVector<int> tail = vector.slice(-10);
+  assertEquals(10, tail.size());
+  assertEquals(90, tail.first());
+  assertThrows(VectorAccessException<int>, vector.slice(90, 20));
+  
+  // changing a slice copies only its range
+  slice.removeAt(0);
+  assertEquals(19, slice.size());
+  assertEquals(11, slice.first());
+  assertEquals(10, vector[10]);
+  
+  slice.sort([](int left, int right) { return left > right; });
+  assertEquals(29, slice.first());
+  assertEquals(11, vector[11]);
+  
+  tail.map([](int value) { return -value; });
+  assertEquals(-90, tail.first());
+  assertEquals(90, vector[90]);
+  
+  tail.clear();
+  assertEquals(0, tail.size());
+  assertEquals(100, vector.size());
+}
+
+void testSharedMutations() {
+  SharedVector<string> vector;
+  vector << "c" << "a" << "b";
+  SharedVector<string> copy = vector;
+  
+  copy.sort();
+  assertEquals(string("{a, b, c}"), copy.toString());
+  assertEquals(string("{c, a, b}"), vector.toString());
+  
+  copy = vector;
+  copy.reverse();
+  assertEquals(string("{b, a, c}"), copy.toString());
+  
+  copy = vector;
+  assertEquals(1, copy.remove("a"));
+  assertEquals(0, copy.remove("x"));
+  assertEquals(2, copy.size());
+  assertEquals(3, vector.size());
+  
+  copy = vector;
+  assertEquals(2, copy.removeIf([](const string &item) { return item != "a"; }));
+  assertEquals(string("{a}"), copy.toString());
+  
+  // appending a vector to itself
+  copy = vector;
+  copy.append(copy.view());
+  assertEquals(string("{c, a, b, c, a, b}"), copy.toString());
+  vector.append(vector.view());
+  assertEquals(6, vector.size());
+  
+  copy = vector;
+  copy = copy;
+  assertEquals(true, copy.isShared());
+}
+
+void testSharedThreads() {
+  SharedVector<int> vector;
+  for (int i = 0; i < 1000; ++i) vector << i;
+  
+  // copies are made and destroyed concurrently
+  std::thread threads[4];
+  for (int t = 0; t < 4; ++t) {
+    threads[t] = std::thread([vector, t] {
+      for (int i = 0; i < 10000; ++i) {
+        SharedVector<int> copy = vector.slice(t, 10);
+        if (i % 1000 == 0) copy << i;
+      }
+    });
+  }
+  for (int t = 0; t < 4; ++t) threads[t].join();
+  assertEquals(false, vector.isShared());
+  assertEquals(1000, vector.size());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("SharedVector", 10);
+  suite << testSharedCopies;
+  suite << testSharedSlices;
+  suite << testSharedMutations;
+  suite << testSharedThreads;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include "test.h"
+#include "smallvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testInlineStorage() {
+  SmallVector<int, 4> vector;
+  assertEquals(true, vector.isInline());
+  assertEquals(0, vector.size());
+  
+  vector << 1 << 2 << 3 << 4;
+  assertEquals(true, vector.isInline());
+  assertEquals(4, vector.size());
+  assertEquals(true, (void *)&vector[0] >= (void *)&vector &&
+                     (void *)&vector[3] < (void *)(&vector + 1));
+  
+  // spills to the heap when growing past N
+  vector << 5;
+  assertEquals(false, vector.isInline());
+  assertEquals(5, vector.size());
+  for (int i = 0; i < 5; ++i) {
+    assertEquals(i + 1, vector[i]);
+  }
+}
+
+void testAccess() {
+  SmallVector<int, 8> vector;
+  assertThrows(VectorAccessException<int>, vector.first());
+  vector << 10 << 20 << 30;
+  assertEquals(10, vector.first());
+  assertEquals(30, vector.last());
+  assertEquals(20, vector[-2]);
+  assertEquals(30, vector.at(-1));
+  vector[0] = 5;
+  assertEquals(5, vector.first());
+  assertThrows(VectorAccessException<int>, vector[3]);
+}
+
+void testSliceSortMap() {
+  int numbers[] = { 5, 3, 8, 1, 9, 2 };
+  SmallVector<int, 8> vector(numbers, 6);
+  assertEquals(true, vector.isInline());
+  
+  vector.sort();
+  assertEquals(1, vector.first());
+  assertEquals(9, vector.last());
+  
+  vector.map([](int value) { return value * 10; });
+  assertEquals(20, vector[1]);
+  
+  SmallVector<int, 8> slice = vector.slice(2, 3);
+  assertEquals(3, slice.size());
+  assertEquals(30, slice.first());
+  assertEquals(true, slice.isInline());
+  assertNotEquals(&vector[2], &slice[0]);
+  assertEquals(std::string("{30, 50, 80}"), slice.toString());
+}
+
+void testCopy() {
+  SmallVector<int, 4> small;
+  small << 1 << 2;
+  SmallVector<int, 4> copy = small;
+  assertEquals(true, copy.isInline());
+  assertNotEquals(&small[0], &copy[0]);
+  assertEquals(2, copy.last());
+  
+  SmallVector<int, 4> big;
+  for (int i = 0; i < 100; ++i) big << i;
+  SmallVector<int, 4> bigCopy = big;
+  assertEquals(false, bigCopy.isInline());
+  assertEquals(99, bigCopy.last());
+  
+  copy = big;
+  assertEquals(100, copy.size());
+  assertEquals(50, copy[50]);
+  
+  // moved small vectors keep their items inline
+  SmallVector<int, 4> moved = std::move(small);
+  assertEquals(true, moved.isInline());
+  assertEquals(2, moved.last());
+  assertEquals(0, small.size());
+  small << 3;
+  assertEquals(true, small.isInline());
+  moved = std::move(big);
+  assertEquals(100, moved.size());
+  assertEquals(99, moved.last());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("SmallVector", 10);
+  suite << testInlineStorage;
+  suite << testAccess;
+  suite << testSliceSortMap;
+  suite << testCopy;
+  suite.run();
+  return 0;
+}
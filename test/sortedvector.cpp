@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <stdlib.h>
+#include "test.h"
+#include "sortedvector.h"
+
+using namespace std;
+using namespace Foundation;
+
+template <typename Search>
+void checkLookups() {
+  int numbers[] = { 5, 3, 8, 3, 1, 9, 3, 5 };
+  SortedVector<int, int, less<int>, Search> vector(VectorView<int>(numbers, 8));
+  assertEquals(string("{1, 3, 3, 3, 5, 5, 8, 9}"), vector.toString());
+  
+  assertEquals(1, vector.lowerBound(3));
+  assertEquals(4, vector.upperBound(3));
+  assertEquals(1, vector.find(3));
+  assertEquals(3, vector.count(3));
+  assertEquals(6, vector.find(8));
+  assertEquals(-1, vector.find(4));
+  assertEquals(-1, vector.find(10));
+  assertEquals(0, vector.lowerBound(0));
+  assertEquals(8, vector.upperBound(9));
+  assertEquals(8, vector.lowerBound(10));
+  assertEquals(0, vector.count(4));
+  assertEquals(true, vector.contains(9));
+  assertEquals(false, vector.contains(0));
+  
+  pair<int, int> range = vector.equalRange(5);
+  assertEquals(4, range.first);
+  assertEquals(6, range.second);
+  
+  // compare with the standard library for many sizes
+  srand(42);
+  for (int size = 0; size < 70; ++size) {
+    SortedVector<int, int, less<int>, Search> random;
+    for (int i = 0; i < size; ++i) random << rand() % 20;
+    for (int item = -1; item < 21; ++item) {
+      assertEquals((int)(lower_bound(random.begin(), random.end(), item) - random.begin()),
+                   random.lowerBound(item));
+      assertEquals((int)(upper_bound(random.begin(), random.end(), item) - random.begin()),
+                   random.upperBound(item));
+    }
+  }
+}
+
+void testLookups() {
+  checkLookups<BinarySearch<int> >();
+  checkLookups<BranchlessSearch<int> >();
+  checkLookups<EytzingerSearch<int> >();
+}
+
+struct Entry {
+  int key;
+  int value;
+};
+
+struct EntryLess {
+  bool operator()(const Entry &left, const Entry &right) const {
+    return left.key < right.key;
+  }
+};
+
+void testInsert() {
+  SortedVector<int> vector;
+  assertEquals(true, vector.isEmpty());
+  assertEquals(0, vector.lowerBound(1));
+  assertEquals(-1, vector.find(1));
+  assertThrows(VectorAccessException<int>, vector.first());
+  
+  assertEquals(0, vector.insert(5));
+  assertEquals(0, vector.insert(1));
+  assertEquals(2, vector.insert(7));
+  vector << 3 << 3;
+  assertEquals(string("{1, 3, 3, 5, 7}"), vector.toString());
+  assertEquals(1, vector.first());
+  assertEquals(7, vector.last());
+  assertEquals(5, vector[-2]);
+  assertThrows(VectorAccessException<int>, vector.at(5));
+  
+  // single items go behind the items that are equal
+  SortedVector<Entry, int, EntryLess> entries;
+  Entry first = { 1, 10 }, second = { 1, 20 }, other = { 0, 30 };
+  entries << first << other << second;
+  assertEquals(0, entries[0].key);
+  assertEquals(10, entries[1].value);
+  assertEquals(20, entries[2].value);
+}
+
+void testBatchInsert() {
+  SortedVector<int> vector;
+  for (int i = 0; i < 10; i += 2) vector << i;
+  
+  int numbers[] = { 9, 1, 4, -1, 11 };
+  vector.insert(VectorView<int>(numbers, 5));
+  assertEquals(string("{-1, 0, 1, 2, 4, 4, 6, 8, 9, 11}"), vector.toString());
+  
+  // the items of the vector itself
+  vector.insert(vector.view());
+  assertEquals(20, vector.size());
+  assertEquals(4, vector.count(4));
+  assertEquals(2, vector.count(11));
+  assertEquals(true, is_sorted(vector.begin(), vector.end()));
+  
+  // equal items of the batch go behind the items of the vector
+  SortedVector<Entry, int, EntryLess> entries;
+  Entry first = { 1, 10 }, second = { 1, 20 }, other = { 2, 30 };
+  entries << first;
+  Entry batch[] = { other, second };
+  entries.insert(VectorView<Entry>(batch, 2));
+  assertEquals(10, entries[0].value);
+  assertEquals(20, entries[1].value);
+  assertEquals(30, entries[2].value);
+  
+  // equal items of the batch keep their order, like inserting one by one
+  SortedVector<Entry, int, EntryLess> batched, single;
+  Vector<Entry> equal;
+  for (int i = 0; i < 100; ++i) {
+    Entry entry = { i % 3, i };
+    equal << entry;
+    single << entry;
+  }
+  batched.insert(equal);
+  for (int i = 0; i < 100; ++i) {
+    assertEquals(single[i].value, batched[i].value);
+  }
+  
+  // random batches match a sorted copy
+  srand(7);
+  Vector<int> all;
+  SortedVector<int, int, less<int>, EytzingerSearch<int> > merged;
+  for (int round = 0; round < 20; ++round) {
+    Vector<int> random;
+    for (int i = 0; i < round * 13; ++i) random << rand() % 100;
+    all.append(random);
+    merged.insert(random);
+    assertEquals(merged.lowerBound(50),
+                 (int)(lower_bound(merged.begin(), merged.end(), 50) - merged.begin()));
+  }
+  all.sort();
+  assertEquals(all.toString(), merged.toString());
+}
+
+void testRemove() {
+  int numbers[] = { 4, 2, 2, 7, 2, 9 };
+  SortedVector<int, int, less<int>, EytzingerSearch<int> > vector(VectorView<int>(numbers, 6));
+  assertEquals(0, vector.find(2));
+  
+  assertEquals(3, vector.remove(2));
+  assertEquals(0, vector.remove(5));
+  assertEquals(string("{4, 7, 9}"), vector.toString());
+  assertEquals(-1, vector.find(2));
+  assertEquals(1, vector.find(7));
+  
+  string words[] = { "b", "a", "c", "b", "d", "b" };
+  SortedVector<string> strings(VectorView<string>(words, 6));
+  assertEquals(3, strings.remove("b"));
+  assertEquals(string("{a, c, d}"), strings.toString());
+  assertEquals(1, strings.remove("d"));
+  assertEquals(1, strings.remove("a"));
+  assertEquals(string("{c}"), strings.toString());
+  
+  assertEquals(4, vector.removeAt(0));
+  assertEquals(0, vector.find(7));
+  vector.clear();
+  assertEquals(true, vector.isEmpty());
+  assertEquals(-1, vector.find(7));
+}
+
+void testCompare() {
+  int numbers[] = { 1, 5, 3 };
+  SortedVector<int, int, greater<int> > vector(VectorView<int>(numbers, 3));
+  vector << 4;
+  assertEquals(string("{5, 4, 3, 1}"), vector.toString());
+  assertEquals(1, vector.find(4));
+  assertEquals(3, vector.lowerBound(2));
+  assertEquals(5, vector.first());
+  assertEquals(9, vector.pipe().filter([](int item) { return item % 2 == 1; })
+                               .reduce(0, [](int sum, int item) { return sum + item; }));
+  
+  ostringstream details;
+  details << "<Foundation::SortedVector#" << &vector << " size:4 values:{5, 4, 3, 1}>";
+  assertEquals(details.str(), vector.inspect());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("SortedVector", 10);
+  suite << testLookups;
+  suite << testInsert;
+  suite << testBatchInsert;
+  suite << testRemove;
+  suite << testCompare;
+  suite.run();
+  return 0;
+}
@@ -0,0 +1,95 @@
+#define FOUNDATION_VECTOR_STATS
+#include <iostream>
+#include <string>
+#include "test.h"
+#include "vector.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testAllocations() {
+  VectorStats::resetProcess();
+  {
+    Vector<int> vector(4);
+    assertEquals((uint64_t)16, vector.stats().allocatedBytes);
+    for (int i = 0; i < 100; ++i) vector << i;
+    
+    // 4 -> 8 -> 16 -> 32 -> 64 -> 128
+    VectorStats stats = vector.stats();
+    assertEquals((uint64_t)5, stats.reallocations);
+    assertEquals((uint64_t)(128 * sizeof(int)), stats.peakCapacityBytes);
+    assertEquals((uint64_t)(100 * sizeof(int)), stats.peakSizeBytes);
+    assertEquals((uint64_t)((4 + 8 + 16 + 32 + 64) * sizeof(int)), stats.movedBytes);
+    assertEquals((uint64_t)((8 + 16 + 32 + 64 + 128) * sizeof(int)),
+                 stats.allocatedBytes - 16);
+    assertEquals(stats.allocatedBytes - 128 * sizeof(int), stats.freedBytes);
+    
+    vector.resetStats();
+    assertEquals((uint64_t)0, vector.stats().reallocations);
+  }
+  
+  // all allocated bytes were freed
+  VectorStats process = VectorStats::process();
+  assertEquals(process.allocatedBytes, process.freedBytes);
+  assertEquals((uint64_t)5, process.reallocations);
+  assertEquals(true, VectorStats::enabled());
+}
+
+void testMoves() {
+  Vector<int> vector(100);
+  for (int i = 0; i < 100; ++i) vector << i;
+  uint64_t moved = vector.stats().movedBytes;
+  
+  // removing the front shifts all other items
+  vector.removeAt(0);
+  assertEquals((uint64_t)(99 * sizeof(int)), vector.stats().movedBytes - moved);
+  vector.removeAt(-1);
+  assertEquals((uint64_t)(99 * sizeof(int)), vector.stats().movedBytes - moved);
+  
+  moved = vector.stats().movedBytes;
+  int items[] = { -1, -2 };
+  vector.insertAt(10, items, 2);
+  assertEquals((uint64_t)((88 + 2) * sizeof(int)), vector.stats().movedBytes - moved);
+  
+  // copies start with new counters
+  Vector<int> copy = vector.copy();
+  assertEquals((uint64_t)(100 * sizeof(int)), copy.stats().movedBytes);
+  assertEquals((uint64_t)0, copy.stats().reallocations);
+}
+
+int compareDescending(const int &left, const int &right) {
+  return right - left;
+}
+
+void testComparisons() {
+  Vector<int> vector;
+  for (int i = 0; i < 1000; ++i) vector << (i * 7919) % 1000;
+  
+  vector.sort(compareDescending);
+  uint64_t comparisons = vector.stats().comparisons;
+  assertEquals(true, comparisons > 1000 && comparisons < 1000 * 100);
+  assertEquals(999, vector.first());
+  
+  // the radix sort doesn't compare
+  vector.sort();
+  assertEquals(comparisons, vector.stats().comparisons);
+}
+
+void testJson() {
+  Vector<int> vector(2);
+  vector << 1 << 2 << 3;
+  assertEquals(string("{\"enabled\": true, \"reallocations\": 1, \"allocatedBytes\": 24, "
+                      "\"freedBytes\": 8, \"movedBytes\": 8, \"comparisons\": 0, "
+                      "\"peakCapacityBytes\": 16, \"peakSizeBytes\": 12}"),
+               vector.stats().toJson());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("VectorStats", 10);
+  suite << testAllocations;
+  suite << testMoves;
+  suite << testComparisons;
+  suite << testJson;
+  suite.run();
+  return 0;
+}
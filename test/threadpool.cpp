@@ -0,0 +1,91 @@
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include "test.h"
+#include "threadpool.h"
+
+using namespace std;
+using namespace Foundation;
+
+void testRunsAllTasks() {
+  ThreadPool pool(3);
+  TaskGroup group;
+  atomic<int> counter(0);
+  for (int i = 0; i < 1000; ++i) {
+    pool.submit(group, [&counter] { counter++; });
+  }
+  pool.wait(group);
+  assertEquals(1000, counter.load());
+  assertEquals(true, group.isDone());
+}
+
+void testWaitingThreadWorks() {
+  // without workers the waiting thread runs all tasks
+  ThreadPool pool(0);
+  TaskGroup group;
+  int counter = 0;
+  for (int i = 0; i < 10; ++i) {
+    pool.submit(group, [&counter] { counter++; });
+  }
+  pool.wait(group);
+  assertEquals(10, counter);
+  assertEquals(1u, pool.size());
+}
+
+void sumRange(ThreadPool &pool, TaskGroup &group, atomic<long> &sum, 
+              long from, long to) {
+  if (to - from <= 100) {
+    for (long i = from; i < to; ++i) sum += i;
+    return;
+  }
+  long middle = from + (to - from) / 2;
+  pool.submit(group, [&pool, &group, &sum, from, middle] {
+    sumRange(pool, group, sum, from, middle);
+  });
+  sumRange(pool, group, sum, middle, to);
+}
+
+void testNestedTasks() {
+  ThreadPool pool(3);
+  TaskGroup group;
+  atomic<long> sum(0);
+  sumRange(pool, group, sum, 0, 100000);
+  pool.wait(group);
+  assertEquals(100000L * 99999L / 2, sum.load());
+}
+
+void testTaskException() {
+  ThreadPool pool(2);
+  TaskGroup group;
+  pool.submit(group, [] { throw runtime_error("failed"); });
+  assertThrows(runtime_error, pool.wait(group));
+  
+  // the pool keeps working
+  TaskGroup other;
+  int counter = 0;
+  pool.submit(other, [&counter] { counter++; });
+  pool.wait(other);
+  assertEquals(1, counter);
+}
+
+void testSharedPool() {
+  TaskGroup group;
+  atomic<int> counter(0);
+  for (int i = 0; i < 100; ++i) {
+    ThreadPool::shared().submit(group, [&counter] { counter++; });
+  }
+  ThreadPool::shared().wait(group);
+  assertEquals(100, counter.load());
+  assertEquals(&ThreadPool::shared(), &ThreadPool::shared());
+}
+
+int main (int argc, char * const argv[]) {
+  Test::Suite suite("ThreadPool", 10);
+  suite << testRunsAllTasks;
+  suite << testWaitingThreadWorks;
+  suite << testNestedTasks;
+  suite << testTaskException;
+  suite << testSharedPool;
+  suite.run();
+  return 0;
+}
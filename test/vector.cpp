@@ -1,4 +1,11 @@
 #include <iostream>
+#include <math.h>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <thread>
 #include "test.h"
 #include "vector.h"
 
@@ -73,6 +80,130 @@ void testIndexOfElement() {
   assertEquals(3, vector.lastIndex(20));
 }
 
+template <typename Item>
+void checkSearch(int size) {
+  Vector<Item> vector;
+  for (int i = 0; i < size; ++i) {
+    vector << (Item)(i % 100);
+  }
+  
+  for (int i = 0; i < 100 && i < size; ++i) {
+    assertEquals(i, (int)vector.index((Item)i));
+    assertEquals(((size - 1 - i) / 100) * 100 + i, (int)vector.lastIndex((Item)i));
+    assertEquals((size - 1 - i) / 100 + 1, (int)vector.count((Item)i));
+    assertEquals(true, vector.contains((Item)i));
+  }
+  assertEquals(-1, (int)vector.index((Item)101));
+  assertEquals(-1, (int)vector.lastIndex((Item)101));
+  assertEquals(0, (int)vector.count((Item)101));
+  assertEquals(false, vector.contains((Item)101));
+}
+
+void testSearchKernels() {
+  Simd::Level levels[] = { Simd::SCALAR, Simd::SSE2, Simd::AVX2 };
+  int sizes[] = { 1, 7, 63, 100, 257, 1000, 20000 };
+  for (int l = 0; l < 3; ++l) {
+    Simd::setLevel(levels[l]);
+    for (int s = 0; s < 7; ++s) {
+      checkSearch<char>(sizes[s]);
+      checkSearch<short>(sizes[s]);
+      checkSearch<int>(sizes[s]);
+      checkSearch<long long>(sizes[s]);
+      checkSearch<float>(sizes[s]);
+      checkSearch<double>(sizes[s]);
+    }
+  }
+  Simd::setLevel(Simd::AVX2);
+  
+  // -0.0 equals 0.0, NaN equals nothing
+  Vector<double> doubles;
+  doubles << 1.0 << -0.0 << 0.0 / 0.0;
+  assertEquals(1, doubles.index(0.0));
+  assertEquals(-1, doubles.index(0.0 / 0.0));
+}
+
+template <typename Item>
+void checkAggregates(int size) {
+  Vector<Item> vector;
+  for (int i = 0; i < size; ++i) {
+    int value = (i * 7919) % 1000;
+    vector << (Item)(std::is_signed<Item>::value ? value - 500 : value);
+  }
+  
+  double sum = 0;
+  int minimum = 0, maximum = 0;
+  for (int i = 0; i < size; ++i) {
+    sum += vector[i];
+    if (vector[i] < vector[minimum]) minimum = i;
+    if (vector[maximum] < vector[i]) maximum = i;
+  }
+  
+  assertEquals(sum, (double)vector.sum());
+  assertEquals(sum / size, vector.mean());
+  assertEquals(vector[minimum], vector.min());
+  assertEquals(vector[maximum], vector.max());
+  assertEquals(vector[minimum], vector.minmax().first);
+  assertEquals(vector[maximum], vector.minmax().second);
+  assertEquals(minimum, vector.argmin());
+  assertEquals(maximum, vector.argmax());
+}
+
+void testAggregates() {
+  Simd::Level level = Simd::level();
+  Simd::Level levels[] = { Simd::SCALAR, Simd::SSE2, Simd::AVX2 };
+  int sizes[] = { 1, 7, 17, 63, 100, 257, 1000, 20000 };
+  for (int l = 0; l < 3; ++l) {
+    Simd::setLevel(levels[l]);
+    for (int s = 0; s < 8; ++s) {
+      checkAggregates<int>(sizes[s]);
+      checkAggregates<unsigned>(sizes[s]);
+      checkAggregates<float>(sizes[s]);
+      checkAggregates<double>(sizes[s]);
+      checkAggregates<short>(sizes[s]);
+      checkAggregates<long long>(sizes[s]);
+    }
+  }
+  Simd::setLevel(level);
+  
+  // the sum doesn't overflow for 32 bit items
+  Vector<int> big;
+  big.fill(2000000000, 100);
+  assertEquals(200000000000LL, (long long)big.sum());
+  Vector<unsigned> unsignedBig;
+  unsignedBig.fill(4000000000u, 100);
+  assertEquals(400000000000ULL, (unsigned long long)unsignedBig.sum());
+  
+  // empty vectors
+  Vector<int> empty;
+  assertEquals(0LL, (long long)empty.sum());
+  assertEquals(-1, empty.argmin());
+  assertEquals(-1, empty.argmax());
+  assertEquals(true, empty.mean() != empty.mean());
+  assertThrows(VectorAccessException<int>, empty.min());
+  assertThrows(VectorAccessException<int>, empty.max());
+  assertThrows(VectorAccessException<int>, empty.minmax());
+  
+  // NaNs are skipped unless the first item is NaN
+  Vector<double> doubles;
+  doubles.fill(1.0, 40);
+  doubles[3] = 0.0 / 0.0;
+  doubles[20] = -2.0;
+  doubles[30] = 5.0;
+  assertEquals(-2.0, doubles.min());
+  assertEquals(5.0, doubles.max());
+  assertEquals(20, doubles.argmin());
+  doubles[0] = 0.0 / 0.0;
+  assertEquals(true, doubles.min() != doubles.min());
+  assertEquals(0, doubles.argmax());
+  
+  // other types use the scalar loop
+  Vector<string> strings;
+  strings << "b" << "a" << "c";
+  assertEquals(string("a"), strings.min());
+  assertEquals(2, strings.argmax());
+  assertEquals(string("bac"), strings.sum());
+}
+
 void testCopy() {
   // create original
   Vector<int> vector;
@@ -117,6 +248,55 @@ void testSlicing() {
   assertEquals(10, slice3.size());
 }
 
+void testView() {
+  Vector<int> vector;
+  for (int i = 0; i < 100; ++i) {
+    vector << i;
+  }
+  
+  // views share the elements of the vector
+  VectorView<int> all = vector.view();
+  assertEquals(100, all.size());
+  assertEquals((const int *)&vector[0], &all[0]);
+  assertEquals(99, all.last());
+  
+  VectorView<int> window = vector.view(50, 10);
+  assertEquals(10, window.size());
+  assertEquals(50, window.first());
+  assertEquals(59, window[-1]);
+  assertEquals((const int *)&vector[50], &window[0]);
+  assertEquals(3, window.index(53));
+  assertEquals(-1, window.index(60));
+  assertEquals(true, window.contains(59));
+  assertEquals(std::string("{50, 51, 52, 53, 54, 55, 56, 57, 58, 59}"), 
+               window.toString());
+  assertThrows(VectorAccessException<int>, window[10]);
+  assertThrows(VectorAccessException<int>, vector.view(95, 10));
+  
+  // negative indexes count from the end
+  VectorView<int> tail = vector.view(-10);
+  assertEquals(10, tail.size());
+  assertEquals(90, tail.first());
+  
+  // slicing a view returns a view
+  VectorView<int> sub = window.slice(2, 3);
+  assertEquals(3, sub.size());
+  assertEquals(52, sub.first());
+  assertEquals((const int *)&vector[52], &sub[0]);
+  assertEquals(55, window.slice(5).first());
+  
+  int sum = 0;
+  for (const int *i = sub.begin(); i != sub.end(); ++i) {
+    sum += *i;
+  }
+  assertEquals(52 + 53 + 54, sum);
+  
+  // copies own their elements
+  Vector<int> copy = sub.copy();
+  assertEquals(3, copy.size());
+  assertNotEquals(&vector[52], &copy[0]);
+}
+
 int powerOfTwo(int value) {
   return value * value;
 }
@@ -134,6 +314,20 @@ void testMapping() {
   }
 }
 
+void testMappingCallables() {
+  Vector<int> vector;
+  for (int i = 0; i < 100; ++i) {
+    vector << i;
+  }
+  
+  int offset = 5;
+  vector.map([offset](int value) { return value + offset; });
+  
+  for (int i = 0; i < 100; ++i) {
+    assertEquals(i + 5, vector[i]);
+  }
+}
+
 void testReverse() {
   Vector<int> vector;
   
@@ -200,6 +394,214 @@ void testSort() {
   assertEquals(0, vector[0]);
 }
 
+bool isSorted(Vector<int> &vector) {
+  for (int i = 1; i < vector.size(); ++i) {
+    if (vector[i - 1] > vector[i]) return false;
+  }
+  return true;
+}
+
+void testSortPatterns() {
+  int size = 10000;
+  Vector<int> sorted, reversed, organPipe, fewUnique, random, equal;
+  srand(42);
+  for (int i = 0; i < size; ++i) {
+    sorted << i;
+    reversed << size - i;
+    organPipe << (i < size / 2 ? i : size - i);
+    fewUnique << rand() % 4;
+    random << rand();
+    equal << 7;
+  }
+  
+  // the sorted vector still contains the same elements
+  int zeros = 0;
+  for (int i = 0; i < size; ++i) {
+    if (fewUnique[i] == 0) zeros++;
+  }
+  
+  sorted.sort();
+  assertEquals(true, isSorted(sorted));
+  reversed.sort();
+  assertEquals(true, isSorted(reversed));
+  assertEquals(1, reversed.first());
+  assertEquals(size, reversed.last());
+  organPipe.sort();
+  assertEquals(true, isSorted(organPipe));
+  fewUnique.sort();
+  assertEquals(true, isSorted(fewUnique));
+  random.sort();
+  assertEquals(true, isSorted(random));
+  equal.sort();
+  assertEquals(true, isSorted(equal));
+  assertEquals(size, equal.size());
+  assertEquals(zeros, fewUnique.lastIndex(0) + 1);
+}
+
+int coarseOrder(const int &left, const int &right) {
+  return defaultCompare(left / 1000, right / 1000);
+}
+
+/// the thread that calls sortParallel and its number of comparisons
+static std::thread::id sortingThread;
+static long sortingComparisons;
+
+/**
+ * throws on the sorting thread, after the first partitions were handed to
+ * the pool
+ */
+int throwingOrder(const int &left, const int &right) {
+  if (std::this_thread::get_id() == sortingThread && ++sortingComparisons > 250000) {
+    throw 1;
+  }
+  return defaultCompare(left, right);
+}
+
+void testSortParallel() {
+  int size = 200000;
+  Vector<int> serial, parallel;
+  srand(42);
+  for (int i = 0; i < size; ++i) {
+    int value = rand() % 100000;
+    serial << value;
+    parallel << value;
+  }
+  
+  // elements with equal keys must end up in the same order as serial
+  ThreadPool pool(3);
+  serial.sort(coarseOrder);
+  parallel.sortParallel(pool, coarseOrder);
+  for (int i = 0; i < size; ++i) {
+    assertEquals(serial[i], parallel[i]);
+  }
+  
+  serial.sort();
+  parallel.sortParallel(4);
+  for (int i = 0; i < size; ++i) {
+    assertEquals(serial[i], parallel[i]);
+  }
+  assertEquals(true, isSorted(parallel));
+  
+  // numbers take the radix sort on both paths, which orders signed zeros
+  // and NaNs the same way
+  Vector<double> serialDoubles, parallelDoubles;
+  for (int i = 0; i < size; ++i) {
+    double value = i % 3 == 0 ? -0.0 : i % 3 == 1 ? 0.0 : (rand() % 100) - 50.0;
+    if (i % 1000 == 0) value = i % 2000 ? NAN : -NAN;
+    serialDoubles << value;
+    parallelDoubles << value;
+  }
+  serialDoubles.sort();
+  parallelDoubles.sortParallel(pool);
+  assertEquals(0, memcmp(&serialDoubles[0], &parallelDoubles[0],
+                         sizeof(double) * size));
+  parallelDoubles.sortParallel(pool, less<double>());
+  assertEquals(0, memcmp(&serialDoubles[0], &parallelDoubles[0],
+                         sizeof(double) * size));
+  
+  // the tasks are finished before an exception of the compare function
+  // leaves sortParallel
+  sortingThread = std::this_thread::get_id();
+  sortingComparisons = 0;
+  assertThrows(int, parallel.sortParallel(pool, throwingOrder));
+  parallel.sortParallel(pool, coarseOrder);
+  serial.sort(coarseOrder);
+  for (int i = 0; i < size; ++i) {
+    assertEquals(serial[i] / 1000, parallel[i] / 1000);
+  }
+  
+  // small vectors use the serial path
+  Vector<int> small;
+  small << 3 << 1 << 2;
+  small.sortParallel();
+  assertEquals(1, small[0]);
+  assertEquals(3, small[2]);
+}
+
+void testRadixSort() {
+  int size = 5000;
+  Vector<long> longs;
+  Vector<double> doubles;
+  Vector<unsigned char> bytes;
+  srand(42);
+  for (int i = 0; i < size; ++i) {
+    longs << (long)rand() * (rand() % 2 ? -1 : 1) * 1000;
+    doubles << (rand() - RAND_MAX / 2) / 1000.0;
+    bytes << rand() % 256;
+  }
+  doubles << -0.0 << 0.0 << -1e300 << 1e300;
+  
+  longs.sort();
+  for (int i = 1; i < longs.size(); ++i) {
+    assertEquals(true, longs[i - 1] <= longs[i]);
+  }
+  
+  doubles.sort();
+  for (int i = 1; i < doubles.size(); ++i) {
+    assertEquals(true, doubles[i - 1] <= doubles[i]);
+  }
+  assertEquals(-1e300, doubles.first());
+  assertEquals(1e300, doubles.last());
+  assertEquals(true, doubles.index(-0.0) < doubles.lastIndex(0.0));
+  
+  bytes.sort();
+  for (int i = 1; i < bytes.size(); ++i) {
+    assertEquals(true, bytes[i - 1] <= bytes[i]);
+  }
+  
+  // the same result as the comparison sort
+  Vector<int> radix, comparison;
+  for (int i = 0; i < size; ++i) {
+    int value = rand() - RAND_MAX / 2;
+    radix << value;
+    comparison << value;
+  }
+  radix.sort();
+  comparison.sort(descOrder);
+  for (int i = 0; i < size; ++i) {
+    assertEquals(comparison[i], radix[i]);
+  }
+}
+
+void testSortCallables() {
+  int numbers[] = {
+    1, 22, 4, 15, 69, 7, 88, 90, 0, 7
+  };
+  Vector<int> vector(numbers, 10);
+  
+  // less predicate
+  vector.sort(std::greater<int>());
+  assertEquals(90, vector.first());
+  assertEquals(0, vector.last());
+  assertEquals(7, vector[5]);
+  assertEquals(7, vector[6]);
+  
+  // compare function with captured state
+  int comparisons = 0;
+  vector.sort([&comparisons](const int &left, const int &right) {
+    comparisons++;
+    return defaultCompare(left, right);
+  });
+  assertEquals(0, vector.first());
+  assertEquals(90, vector.last());
+  assertNotEquals(0, comparisons);
+  
+  // big vectors with std::less use the radix sort
+  Vector<int> big;
+  srand(42);
+  for (int i = 0; i < 1000; ++i) big << rand();
+  big.sort(std::less<int>());
+  assertEquals(true, isSorted(big));
+  
+  Vector<int> parallel;
+  for (int i = 0; i < 100000; ++i) parallel << rand() % 1000;
+  ThreadPool pool(2);
+  parallel.sortParallel(pool, [](const int &left, const int &right) {
+    return left < right;
+  });
+  assertEquals(true, isSorted(parallel));
+}
+
 void testRemoveAt() {
   int numbers[] = {
     1, 22, 4, 15, 69, 7, 88, 90, 0, 7
@@ -224,6 +626,16 @@ void testRemoveAt() {
   vector.removeAt(-1);
   assertEquals(7, vector.size());
   assertEquals(0, vector.last());
+  
+  // ranges
+  assertThrows(VectorAccessException<int>, vector.removeRange(5, 3));
+  vector.removeRange(1, 2);
+  assertEquals(string("{22, 7, 88, 90, 0}"), vector.toString());
+  vector.removeRange(-2, 2);
+  assertEquals(string("{22, 7, 88}"), vector.toString());
+  vector.removeRange(0, 0);
+  vector.removeRange(0, 3);
+  assertEquals(true, vector.isEmpty());
 }
 
 void testRemove() {
@@ -240,21 +652,390 @@ void testRemove() {
   assertEquals(7, vector.size());
 }
 
+void testRemoveAdjacent() {
+  int numbers[] = {
+    7, 7, 1, 7, 7, 7, 2, 7
+  };
+  Vector<int> vector(numbers, 8);
+  
+  assertEquals(6, vector.remove(7));
+  assertEquals(2, vector.size());
+  assertEquals(1, vector[0]);
+  assertEquals(2, vector[1]);
+}
+
+bool isOdd(int value) {
+  return value % 2 == 1;
+}
+
+void testRemoveIf() {
+  Vector<int> vector;
+  for (int i = 0; i < 100; ++i) {
+    vector << i;
+  }
+  
+  assertEquals(50, vector.removeIf(isOdd));
+  assertEquals(50, vector.size());
+  for (int i = 0; i < 50; ++i) {
+    assertEquals(i * 2, vector[i]);
+  }
+  
+  int limit = 50;
+  assertEquals(25, vector.removeIf([limit](int value) { return value >= limit; }));
+  assertEquals(48, vector.last());
+  assertEquals(0, vector.removeIf(isOdd));
+}
+
+void testRemoveAll() {
+  Vector<int> vector;
+  for (int i = 0; i < 1000; ++i) {
+    vector << i % 100;
+  }
+  
+  // few items are searched linearly
+  Vector<int> few;
+  few << 3 << 5 << 1000;
+  assertEquals(20, vector.removeAll(few));
+  assertEquals(980, vector.size());
+  assertEquals(-1, vector.index(3));
+  assertEquals(-1, vector.index(5));
+  
+  // many items are searched using binary search
+  Vector<int> many;
+  for (int i = 99; i >= 50; --i) {
+    many << i;
+  }
+  assertEquals(500, vector.removeAll(many));
+  assertEquals(480, vector.size());
+  for (int i = 0; i < vector.size(); ++i) {
+    assertEquals(true, vector[i] < 50);
+  }
+  assertEquals(49, vector.last());
+  
+  // the items itself are unchanged
+  assertEquals(99, many.first());
+}
+
+/*
+ * counts the living instances to check that every item that is constructed
+ * by the vector is also destroyed
+ */
+struct Tracked {
+  static int alive;
+  static int copies;
+  int value;
+  
+  Tracked(int value = 0) :value(value) { alive++; }
+  Tracked(const Tracked &other) :value(other.value) { alive++; copies++; }
+  Tracked(Tracked &&other) noexcept :value(other.value) { alive++; }
+  ~Tracked() { alive--; }
+  Tracked &operator=(const Tracked &other) = default;
+  Tracked &operator=(Tracked &&other) = default;
+  bool operator==(const Tracked &other) const { return value == other.value; }
+};
+
+int Tracked::alive = 0;
+int Tracked::copies = 0;
+
+void testNonTrivialItems() {
+  Vector<string> vector(1);
+  for (int i = 0; i < 100; ++i) {
+    vector << string(40, 'a' + i % 26);
+  }
+  assertEquals(100, vector.size());
+  assertEquals(string(40, 'b'), vector[27]);
+  
+  // items that are part of the vector can be added while it grows
+  vector.shrinkToFit();
+  vector << vector[0];
+  assertEquals(string(40, 'a'), vector.last());
+  
+  assertEquals(string(40, 'a'), vector.removeAt(0));
+  assertEquals(string(40, 'b'), vector.first());
+  assertEquals(4, vector.remove(string(40, 'c')));
+  assertEquals(96, vector.size());
+  
+  Vector<string> copy = vector.slice(10, 20);
+  assertEquals(vector[10], copy[0]);
+  vector.clear();
+  assertEquals(string(40, 'a' + 12 % 26), copy[0]);
+  
+  copy.sort();
+  for (int i = 1; i < copy.size(); ++i) {
+    assertEquals(true, copy[i - 1] <= copy[i]);
+  }
+  
+  Vector<string> assigned;
+  assigned << "old";
+  assigned = copy;
+  assertEquals(copy.size(), assigned.size());
+  assertEquals(copy.last(), assigned.last());
+}
+
+void testEmplaceAndReserve() {
+  {
+    Vector<Tracked> vector(0);
+    vector.emplace(1);
+    Tracked item(2);
+    vector.push(std::move(item));
+    assertEquals(2, vector.last().value);
+    
+    Tracked::copies = 0;
+    for (int i = 0; i < 1000; ++i) vector.emplace(i);
+    // growing moves the items
+    assertEquals(0, Tracked::copies);
+    assertEquals(1002, vector.size());
+    
+    vector.removeAt(0);
+    vector.removeIf([](const Tracked &item) { return item.value % 2 == 0; });
+    assertEquals(500, vector.size());
+    // the vector and the local item
+    assertEquals(501, Tracked::alive);
+  }
+  assertEquals(0, Tracked::alive);
+  
+  // vectors of vectors are moved when the outer vector grows
+  {
+    Vector<Vector<Tracked> > nested(1);
+    Tracked::copies = 0;
+    for (int i = 0; i < 100; ++i) {
+      Vector<Tracked> inner;
+      inner.emplace(i);
+      nested.push(std::move(inner));
+      assertEquals(0, inner.size());
+    }
+    assertEquals(0, Tracked::copies);
+    assertEquals(99, nested.last().first().value);
+  }
+  Vector<Vector<string> > strings(1);
+  strings.emplace();
+  strings.first() << string(40, 'a');
+  string *first = &strings.first().first();
+  for (int i = 0; i < 100; ++i) strings.emplace(3);
+  assertEquals(first, &strings.first().first());
+  
+  // moved vectors take the elements, the other vector is empty and usable
+  Vector<string> moved(std::move(strings.first()));
+  assertEquals(first, &moved.first());
+  assertEquals(0, strings.first().size());
+  strings.first() << string("again");
+  assertEquals(string("again"), strings.first().last());
+  moved = std::move(strings.first());
+  assertEquals(string("again"), moved.first());
+  assertEquals(true, strings.first().isEmpty());
+  
+  Vector<int> vector(0);
+  vector.reserve(100);
+  assertEquals(100, vector.capacity());
+  for (int i = 0; i < 100; ++i) vector << i;
+  assertEquals(100, vector.capacity());
+  vector << 100;
+  assertEquals(200, vector.capacity());
+  vector.shrinkToFit();
+  assertEquals(101, vector.capacity());
+  assertEquals(100, vector.last());
+  
+  vector.clear();
+  vector.shrinkToFit();
+  assertEquals(0, vector.capacity());
+  vector << 1;
+  assertEquals(1, vector.first());
+}
+
+void testBulkAppend() {
+  int numbers[] = {1, 2, 3, 4, 5};
+  Vector<int> vector(1);
+  vector.append(numbers, 5);
+  assertEquals(5, vector.size());
+  assertEquals(5, vector.last());
+  
+  // appending the vector to itself copies the items before growing
+  vector.append(vector);
+  assertEquals(10, vector.size());
+  assertEquals(1, vector[5]);
+  assertEquals(5, vector.last());
+  
+  vector.append(vector.view(0, 2));
+  assertEquals(2, vector.last());
+  
+  vector.clear();
+  vector.fill(7, 3);
+  assertEquals(3, vector.count(7));
+  vector.fill(vector[0], 100);
+  assertEquals(103, vector.size());
+  assertEquals(7, vector.last());
+  
+  Vector<string> strings;
+  strings.fill("a", 3);
+  string more[] = {"b", "c"};
+  strings.append(more, 2);
+  assertEquals(string("a"), strings[2]);
+  assertEquals(string("c"), strings.last());
+}
+
+void testInsertAt() {
+  int numbers[] = {1, 2, 3};
+  Vector<int> vector;
+  vector << 10 << 20;
+  vector.insertAt(1, numbers, 3);
+  assertEquals(string("{10, 1, 2, 3, 20}"), vector.toString());
+  vector.insertAt(0, numbers, 1);
+  assertEquals(string("{1, 10, 1, 2, 3, 20}"), vector.toString());
+  vector.insertAt(vector.size(), numbers + 2, 1);
+  assertEquals(3, vector.last());
+  vector.insertAt(-1, numbers, 2);
+  assertEquals(string("{1, 10, 1, 2, 3, 20, 1, 2, 3}"), vector.toString());
+  
+  // items of the vector itself
+  vector.insertAt(1, vector.view(-3));
+  assertEquals(string("{1, 1, 2, 3, 10, 1, 2, 3, 20, 1, 2, 3}"), vector.toString());
+  
+  assertThrows(VectorAccessException<int>, vector.insertAt(13, numbers, 1));
+  assertThrows(VectorAccessException<int>, vector.insertAt(-13, numbers, 1));
+  
+  Vector<string> strings;
+  strings << "a" << "d";
+  string middle[] = {"b", "c"};
+  strings.insertAt(1, middle, 2);
+  assertEquals(string("{a, b, c, d}"), strings.toString());
+}
+
+void testParallelOperations() {
+  ThreadPool pool(3);
+  Vector<int> vector;
+  for (int i = 0; i < 100000; ++i) vector << i;
+  
+  vector.parallelMap(pool, [](int value) { return value * 2; });
+  for (int i = 0; i < vector.size(); ++i) {
+    assertEquals(i * 2, vector[i]);
+  }
+  vector.parallelMap([](int value) { return value / 2; });
+  assertEquals(99999, vector.last());
+  
+  long sum = vector.parallelReduce(pool, 0L, [](long sum, long value) { return sum + value; });
+  assertEquals(99999L * 100000 / 2, sum);
+  assertEquals(sum, vector.parallelReduce(0L, [](long sum, long value) { return sum + value; }));
+  
+  // every item is folded, also the first one of a block
+  long squares = 0;
+  for (int i = 0; i < vector.size(); ++i) squares += (long)vector[i] * vector[i];
+  assertEquals(squares, vector.parallelReduce(pool, 0L, [](long sum, int value) {
+    return sum + (long)value * value;
+  }, [](long left, long right) { return left + right; }));
+  
+  // the blocks are combined in order, so a non commutative operation works
+  Vector<string> strings;
+  for (int i = 0; i < 50000; ++i) strings << string(1, 'a' + i % 26);
+  string joined = strings.parallelReduce(pool, string(), [](string left, const string &right) {
+    return left + right;
+  });
+  assertEquals(50000, (int)joined.size());
+  assertEquals(string("abcdefghijklmnopqrstuvwxyzab"), joined.substr(0, 28));
+  assertEquals('a' + 49999 % 26, (int)joined[49999]);
+  
+  std::atomic<long> count(0);
+  vector.parallelForEach(pool, [&count](int value) {
+    if (value % 2 == 0) count++;
+  });
+  assertEquals(50000L, count.load());
+  
+  Vector<int> empty;
+  assertEquals(7, empty.parallelReduce(pool, 7, [](int left, int right) { return left + right; }));
+  
+  assertThrows(int, vector.parallelForEach(pool, [](int value) {
+    if (value == 90000) throw 1;
+  }));
+}
+
+void testBoundsPolicy() {
+  Vector<int, int, MallocAllocator, Unchecked> vector;
+  for (int i = 0; i < 10; ++i) vector << i * 10;
+  assertEquals(0, vector.first());
+  assertEquals(90, vector.last());
+  assertEquals(30, vector[3]);
+  assertEquals(80, vector[-2]);
+  assertEquals(40, vector.at(4));
+  vector[0] = -1;
+  assertEquals(-1, vector.uncheckedAt(0));
+  
+  // slicing and removing still check their indexes
+  assertThrows(VectorAccessException<int>, vector.slice(5, 10));
+  assertThrows(VectorAccessException<int>, vector.removeAt(10));
+  Vector<int, int, MallocAllocator, Unchecked> slice = vector.slice(-3, 3);
+  assertEquals(string("{70, 80, 90}"), slice.toString());
+  
+  // the checked vector throws and can take the items of the unchecked one
+  Vector<int> checked;
+  checked.append(vector);
+  assertEquals(10, checked.size());
+  assertThrows(VectorAccessException<int>, checked[10]);
+  assertThrows(VectorAccessException<int>, checked.at(-11));
+  
+  const Vector<int> &constant = checked;
+  assertEquals(90, constant[-1]);
+  assertEquals(20, constant.at(2));
+  assertEquals(20, constant.uncheckedAt(2));
+  assertThrows(VectorAccessException<int>, constant[10]);
+}
+
+void testIterators() {
+  Vector<int> vector;
+  for (int i = 0; i < 100; ++i) vector << (i * 37) % 100;
+  
+  long sum = 0;
+  for (int item : vector) sum += item;
+  assertEquals(4950L, sum);
+  
+  // the iterators work with the standard algorithms
+  std::sort(vector.begin(), vector.end());
+  assertEquals(0, vector.first());
+  assertEquals(99, vector.last());
+  assertEquals(true, std::is_sorted(vector.begin(), vector.end()));
+  assertEquals(42L, (long)(std::lower_bound(vector.begin(), vector.end(), 42) - vector.begin()));
+  for (int &item : vector) item *= 2;
+  assertEquals(198, vector.last());
+  
+  const Vector<int> &constant = vector;
+  assertEquals(100L, (long)(constant.end() - constant.begin()));
+  assertEquals(9900L, std::accumulate(constant.begin(), constant.end(), 0L));
+  
+  Vector<int> empty;
+  assertEquals(true, empty.begin() == empty.end());
+}
+
 int main (int argc, char * const argv[]) {
-  Test::Suite suite("Vector", 20);
+  Test::Suite suite("Vector", 40);
   suite << testVectorSize;
   suite << testFirstAndLast;
   suite << testGoodVectorAccess;
   suite << testBadVectorAccess;
   suite << testVectorGrowing;
   suite << testIndexOfElement;
+  suite << testSearchKernels;
+  suite << testAggregates;
   suite << testCopy;
   suite << testSlicing;
+  suite << testView;
   suite << testMapping;
+  suite << testMappingCallables;
   suite << testReverse;
   suite << testSort;
+  suite << testSortPatterns;
+  suite << testSortParallel;
+  suite << testRadixSort;
+  suite << testSortCallables;
   suite << testRemoveAt;
   suite << testRemove;
+  suite << testRemoveAdjacent;
+  suite << testRemoveIf;
+  suite << testRemoveAll;
+  suite << testNonTrivialItems;
+  suite << testEmplaceAndReserve;
+  suite << testBulkAppend;
+  suite << testInsertAt;
+  suite << testParallelOperations;
+  suite << testBoundsPolicy;
+  suite << testIterators;
   suite.run();
   return 0;
 }